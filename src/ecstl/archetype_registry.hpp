@@ -0,0 +1,465 @@
+#pragma once
+#include "registry.hpp"
+
+namespace ecstl {
+
+///Column of an archetype table, holds components of one type
+class IArchetypeColumn {
+public:
+    constexpr virtual ~IArchetypeColumn() {}
+    ///Get the type of the component
+    constexpr virtual ComponentTypeID get_type() const = 0;
+    ///Create empty column of the same type
+    constexpr virtual unique_ptr<IArchetypeColumn> create_empty() const = 0;
+    ///Move item to the end of other column of the same type
+    /** The position is filled by the last item */
+    constexpr virtual void move_item_to(std::size_t pos, IArchetypeColumn &target) = 0;
+    ///Destroy item, the position is filled by the last item
+    constexpr virtual void erase_item(std::size_t pos) = 0;
+};
+
+///Column of an archetype table for components of type T
+template<typename T>
+class ArchetypeColumn: public IArchetypeColumn {
+public:
+
+    constexpr ArchetypeColumn() = default;
+
+    constexpr ~ArchetypeColumn() {
+        if constexpr(is_droppable<T>) {
+            for (auto &v: _data) drop(v);
+        }
+    }
+
+    constexpr virtual ComponentTypeID get_type() const {
+        return component_type_id<T>;
+    }
+    constexpr virtual unique_ptr<IArchetypeColumn> create_empty() const {
+        return make_unique<ArchetypeColumn<T> >();
+    }
+    constexpr virtual void move_item_to(std::size_t pos, IArchetypeColumn &target) {
+        static_cast<ArchetypeColumn &>(target)._data.push_back(std::move(_data[pos]));
+        remove_at(pos);
+    }
+    constexpr virtual void erase_item(std::size_t pos) {
+        if constexpr(is_droppable<T>) {
+            drop(_data[pos]);
+        }
+        remove_at(pos);
+    }
+
+    ///Retrieve components, items are in the same order as entities of the archetype
+    constexpr std::vector<T> &data() {return _data;}
+    constexpr const std::vector<T> &data() const {return _data;}
+
+protected:
+    std::vector<T> _data;
+
+    ///removes moved or dropped item without calling drop()
+    constexpr void remove_at(std::size_t pos) {
+        if (pos + 1 < _data.size()) _data[pos] = std::move(_data.back());
+        _data.pop_back();
+    }
+};
+
+///View over all archetypes which contain given components
+/**
+ * Each archetype is iterated linearly, all columns are accessed at the same
+ * position without any lookup.
+ *
+ * The view is invalidated when a new archetype is created (an entity receives new
+ * combination of components). Don't add or remove components while iterating.
+ *
+ * @tparam Components components of the view, const for read-only access
+ */
+template<typename ... Components>
+class ArchetypeView: public std::ranges::view_interface<ArchetypeView<Components...> > {
+public:
+
+    using Values = std::tuple<const Entity &, Components &...>;
+
+    ///Matching archetype
+    struct Table {
+        const std::vector<Entity> *entities;
+        std::tuple<std::vector<std::remove_const_t<Components> > *...> columns;
+    };
+
+    class Sentinel {};
+
+    class Iterator {
+    public:
+        using value_type = Values;
+        using reference = Values;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr Iterator() = default;
+        constexpr Iterator(const ArchetypeView *owner):_owner(owner) {
+            skip_empty();
+        }
+
+        constexpr reference operator*() const {
+            const Table &t = _owner->_tables[_table];
+            return std::apply([&](auto * ... cols){
+                return Values((*t.entities)[_row], (*cols)[_row]...);
+            }, t.columns);
+        }
+
+        constexpr Iterator &operator++() {
+            ++_row;
+            skip_empty();
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+            auto save = *this;
+            ++(*this);
+            return save;
+        }
+
+        constexpr bool operator==(const Iterator &other) const {
+            return _table == other._table && _row == other._row;
+        }
+
+        constexpr bool operator==(const Sentinel &) const {
+            return _table >= _owner->_tables.size();
+        }
+
+    protected:
+        const ArchetypeView *_owner = nullptr;
+        std::size_t _table = 0;
+        std::size_t _row = 0;
+
+        constexpr void skip_empty() {
+            while (_table < _owner->_tables.size() && _row >= _owner->_tables[_table].entities->size()) {
+                ++_table;
+                _row = 0;
+            }
+        }
+    };
+
+    constexpr ArchetypeView() = default;
+    constexpr explicit ArchetypeView(std::vector<Table> tables):_tables(std::move(tables)) {}
+
+    constexpr Iterator begin() const {return Iterator(this);}
+    constexpr Sentinel end() const {return {};}
+
+    ///Count of rows
+    constexpr std::size_t size() const {
+        std::size_t r = 0;
+        for (const Table &t: _tables) r += t.entities->size();
+        return r;
+    }
+
+protected:
+    std::vector<Table> _tables;
+};
+
+///Registry which stores components in archetype tables
+/**
+ * Entities with the same set of components share an archetype. The archetype stores
+ * the components in columns (one std::vector per component type), rows are entities.
+ * A view visits only matching archetypes and iterates their columns linearly,
+ * so iteration over many components doesn't perform any lookup per entity.
+ *
+ * Adding or removing a component moves the entity to other archetype. Transitions
+ * between archetypes are cached in the archetype (edges), so a repeated
+ * transition doesn't look up the archetype by its signature.
+ *
+ * Use this registry, when many entities share identical component sets and the sets
+ * change rarely. GenericRegistry is better, when components are often added and removed.
+ *
+ * The API follows GenericRegistry (create_entity, set, emplace, get, has, remove,
+ * destroy_entity, view). Variants of components, groups and structure of arrays layout
+ * are not supported.
+ */
+class ArchetypeRegistry {
+public:
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    constexpr ArchetypeRegistry() {
+        _archetypes.push_back(make_unique<Archetype>());
+        _by_signature.emplace(Signature{}, 0);
+    }
+
+    ///Create a new entity
+    /** The entity is placed to the empty archetype */
+    Entity create_entity() {
+        Entity e = Entity::create();
+        place_entity(e);
+        return e;
+    }
+
+    ///Create a new entity with a name
+    Entity create_entity(std::string_view name) {
+        Entity e = create_entity();
+        set<EntityName>(e, EntityName(name));
+        return e;
+    }
+
+    ///Check whether the entity is stored in the registry
+    constexpr bool is_known(Entity e) const {
+        return _locations.find(e) != _locations.end();
+    }
+
+    ///Add or replace a component
+    /**
+     * @retval true component has been created
+     * @retval false component has been replaced
+     */
+    template<typename T>
+    constexpr bool set(Entity e, T data) {
+        return emplace<T>(e, std::move(data));
+    }
+
+    ///Add or replace a component constructed from arguments
+    /**
+     * @retval true component has been created (entity moved to other archetype)
+     * @retval false component has been replaced
+     */
+    template<typename T, typename ... Args>
+    constexpr bool emplace(Entity e, Args && ... args) {
+        using C = std::remove_cvref_t<T>;
+        Location loc = place_entity(e);
+        Archetype &src = *_archetypes[loc.archetype];
+        std::size_t col = src.column_index(component_type_id<C>);
+        if (col != npos) {
+            C &v = src.template column<C>(col).data()[loc.row];
+            if constexpr(is_droppable<C>) drop(v);
+            std::destroy_at(std::addressof(v));
+            std::construct_at(std::addressof(v), std::forward<Args>(args)...);
+            return false;
+        }
+        std::size_t target = transition(loc.archetype, component_type_id<C>, true, [](){
+            return unique_ptr<IArchetypeColumn>(make_unique<ArchetypeColumn<C> >());
+        });
+        migrate(e, loc, target);
+        Archetype &dst = *_archetypes[target];
+        dst.template column<C>(dst.column_index(component_type_id<C>)).data().emplace_back(std::forward<Args>(args)...);
+        return true;
+    }
+
+    ///Get a component of an entity
+    /**
+     * @tparam T type of component, use const T for read-only access
+     * @return reference to the component or empty reference
+     */
+    template<typename T>
+    constexpr OptionalRef<T> get(Entity e) const {
+        using C = std::remove_cvref_t<T>;
+        auto iter = _locations.find(e);
+        if (iter == _locations.end()) return std::nullopt;
+        const Location &loc = iter->second;
+        Archetype &a = *_archetypes[loc.archetype];
+        std::size_t col = a.column_index(component_type_id<C>);
+        if (col == npos) return std::nullopt;
+        return a.template column<C>(col).data()[loc.row];
+    }
+
+    ///Check whether the entity has all components
+    template<typename ... Components>
+    constexpr bool has(Entity e) const {
+        auto iter = _locations.find(e);
+        if (iter == _locations.end()) return false;
+        const Archetype &a = *_archetypes[iter->second.archetype];
+        return ((a.column_index(component_type_id<std::remove_cvref_t<Components> >) != npos) && ...);
+    }
+
+    ///Remove a component from an entity (if it exists)
+    /** The entity is moved to other archetype */
+    template<typename T>
+    constexpr void remove(Entity e) {
+        using C = std::remove_cvref_t<T>;
+        auto iter = _locations.find(e);
+        if (iter == _locations.end()) return;
+        Location loc = iter->second;
+        if (_archetypes[loc.archetype]->column_index(component_type_id<C>) == npos) return;
+        std::size_t target = transition(loc.archetype, component_type_id<C>, false, [](){
+            return unique_ptr<IArchetypeColumn>();
+        });
+        migrate(e, loc, target);
+    }
+
+    ///Destroy an entity and all its components
+    constexpr void destroy_entity(Entity e) {
+        auto iter = _locations.find(e);
+        if (iter == _locations.end()) return;
+        Location loc = iter->second;
+        Archetype &a = *_archetypes[loc.archetype];
+        for (auto &c: a.columns) c->erase_item(loc.row);
+        remove_row(a, loc.row);
+        _locations.erase(e);
+    }
+
+    ///Create a view over entities with all given components
+    /**
+     * @tparam Components types of components, const for read-only access
+     * @return ArchetypeView, each row is tuple of entity and references to components
+     */
+    template<typename ... Components>
+    constexpr ArchetypeView<Components...> view() const {
+        static_assert(sizeof...(Components) >= 1, "At least one component type must be specified");
+        using View = ArchetypeView<Components...>;
+        std::vector<typename View::Table> tables;
+        for (const auto &a: _archetypes) {
+            std::array<std::size_t, sizeof...(Components)> cols = {
+                a->column_index(component_type_id<std::remove_cvref_t<Components> >)...};
+            if (std::find(cols.begin(), cols.end(), npos) != cols.end()) continue;
+            std::size_t idx = 0;
+            tables.push_back(typename View::Table{&a->entities,
+                {&a->template column<std::remove_cvref_t<Components> >(cols[idx++]).data()...}});
+        }
+        return View(std::move(tables));
+    }
+
+    ///Get the name of an entity (if it has EntityName component)
+    constexpr std::string_view get_entity_name(Entity e) const {
+        auto c = get<const EntityName>(e);
+        if (c) return c.value();
+        else return {};
+    }
+
+    constexpr void set_entity_name(Entity e, std::string_view name) {
+        set<EntityName>(e, EntityName(name));
+    }
+
+    ///Count of archetypes (including the empty archetype)
+    constexpr std::size_t archetype_count() const {return _archetypes.size();}
+
+protected:
+
+    ///Sorted list of component types of an archetype
+    struct Signature {
+        std::vector<ComponentTypeID> types;
+        constexpr bool operator==(const Signature &) const = default;
+        constexpr friend std::size_t get_hash(const Signature &s) {
+            ComponentTypeID r;
+            for (const auto &t: s.types) r = r + t;
+            return r.get_id();
+        }
+    };
+
+    ///Cached transition to other archetype
+    struct Edge {
+        ComponentTypeID type;
+        std::size_t add = npos;
+        std::size_t remove = npos;
+    };
+
+    ///Table of entities with the same component types
+    struct Archetype {
+        ///sorted component types
+        Signature signature;
+        ///columns in the same order as types
+        std::vector<unique_ptr<IArchetypeColumn> > columns;
+        std::vector<Entity> entities;
+        std::vector<Edge> edges;
+
+        constexpr std::size_t column_index(ComponentTypeID type) const {
+            const auto &t = signature.types;
+            auto iter = std::lower_bound(t.begin(), t.end(), type);
+            if (iter == t.end() || *iter != type) return npos;
+            return static_cast<std::size_t>(iter - t.begin());
+        }
+
+        template<typename T>
+        constexpr ArchetypeColumn<T> &column(std::size_t idx) const {
+            return static_cast<ArchetypeColumn<T> &>(*columns[idx]);
+        }
+
+        constexpr Edge &edge(ComponentTypeID type) {
+            for (Edge &e: edges) if (e.type == type) return e;
+            return edges.emplace_back(Edge{type});
+        }
+    };
+
+    struct Location {
+        std::size_t archetype;
+        std::size_t row;
+    };
+
+    std::vector<unique_ptr<Archetype> > _archetypes;
+    OpenHashMap<Signature, std::size_t, HashOfKey<Signature> > _by_signature;
+    OpenHashMap<Entity, Location, HashOfKey<Entity> > _locations;
+
+    ///returns location of the entity, unknown entity is placed to the empty archetype
+    constexpr Location place_entity(Entity e) {
+        auto iter = _locations.find(e);
+        if (iter != _locations.end()) return iter->second;
+        Archetype &a = *_archetypes[0];
+        a.entities.push_back(e);
+        Location loc{0, a.entities.size() - 1};
+        _locations.emplace(e, loc);
+        return loc;
+    }
+
+    ///finds or creates archetype which differs by one component type
+    /**
+     * @param from source archetype
+     * @param type added or removed type
+     * @param add true to add the type, false to remove
+     * @param make_column creates column of added type
+     * @return index of target archetype
+     */
+    template<typename Fn>
+    constexpr std::size_t transition(std::size_t from, ComponentTypeID type, bool add, Fn &&make_column) {
+        Edge &edge = _archetypes[from]->edge(type);
+        std::size_t &cached = add?edge.add:edge.remove;
+        if (cached != npos) return cached;
+
+        const Archetype &src = *_archetypes[from];
+        Signature sig = src.signature;
+        auto pos = std::lower_bound(sig.types.begin(), sig.types.end(), type);
+        if (add) sig.types.insert(pos, type);
+        else sig.types.erase(pos);
+
+        std::size_t target;
+        auto iter = _by_signature.find(sig);
+        if (iter != _by_signature.end()) {
+            target = iter->second;
+        } else {
+            auto a = make_unique<Archetype>();
+            for (const ComponentTypeID &t: sig.types) {
+                std::size_t c = src.column_index(t);
+                if (c == npos) a->columns.push_back(make_column());
+                else a->columns.push_back(src.columns[c]->create_empty());
+            }
+            a->signature = sig;
+            target = _archetypes.size();
+            _archetypes.push_back(std::move(a));
+            _by_signature.emplace(std::move(sig), target);
+        }
+        //edge can be moved by creation of reverse edge, store the result first
+        cached = target;
+        Edge &back = _archetypes[target]->edge(type);
+        (add?back.remove:back.add) = from;
+        return target;
+    }
+
+    ///moves entity to other archetype, components missing in the target are destroyed
+    constexpr void migrate(Entity e, const Location &loc, std::size_t target) {
+        Archetype &src = *_archetypes[loc.archetype];
+        Archetype &dst = *_archetypes[target];
+        for (std::size_t i = 0; i < src.columns.size(); ++i) {
+            std::size_t j = dst.column_index(src.signature.types[i]);
+            if (j == npos) src.columns[i]->erase_item(loc.row);
+            else src.columns[i]->move_item_to(loc.row, *dst.columns[j]);
+        }
+        remove_row(src, loc.row);
+        dst.entities.push_back(e);
+        _locations[e] = Location{target, dst.entities.size() - 1};
+    }
+
+    ///removes entity from the list of the archetype, the last entity is moved to the row
+    constexpr void remove_row(Archetype &a, std::size_t row) {
+        if (row + 1 < a.entities.size()) {
+            a.entities[row] = a.entities.back();
+            _locations[a.entities[row]].row = row;
+        }
+        a.entities.pop_back();
+    }
+};
+
+}
@@ -0,0 +1,270 @@
+#pragma once
+#include "registry.hpp"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <span>
+#include <cstddef>
+
+namespace ecstl {
+
+///Records structural changes of a registry to be applied later
+/**
+ * Use the buffer when the registry cannot be modified directly, for example while
+ * a view is being iterated, or in parallel tasks (each task records into its own buffer,
+ * buffers are merged and applied afterwards).
+ *
+ * Payloads of components are moved into an arena owned by the buffer. During
+ * GenericRegistry::apply() the commands are replayed grouped by pool, so every pool
+ * is looked up only once per batch. Order of commands for the same pool is preserved,
+ * destroy_entity() acts as a barrier (commands recorded before it are applied before
+ * the entity is destroyed).
+ *
+ * @tparam Registry type of registry (use GenericRegistry::CommandBuffer)
+ *
+ * @note the buffer itself is not thread safe. Use one buffer per thread and merge them.
+ */
+template<typename Registry>
+class GenericCommandBuffer {
+public:
+
+    GenericCommandBuffer() = default;
+    GenericCommandBuffer(GenericCommandBuffer &&other)
+        :_commands(std::move(other._commands))
+        ,_blocks(std::move(other._blocks))
+        ,_current(other._current)
+        ,_block_used(other._block_used) {
+        other._commands.clear();
+        other._blocks.clear();
+        other._current = nullptr;
+        other._block_used = 0;
+    }
+    GenericCommandBuffer &operator=(GenericCommandBuffer &&other) {
+        if (this != &other) {
+            clear();
+            _commands = std::move(other._commands);
+            _blocks = std::move(other._blocks);
+            _current = other._current;
+            _block_used = other._block_used;
+            other._commands.clear();
+            other._blocks.clear();
+            other._current = nullptr;
+            other._block_used = 0;
+        }
+        return *this;
+    }
+    ~GenericCommandBuffer() {clear();}
+
+    ///Create new entity
+    /** The entity id is allocated immediately, so it can be used in following commands.
+     *  Not available for registries which recycle ids (create entities by the registry) */
+    static Entity create_entity() requires(!Registry::recycles_ids) {
+        return Entity::create();
+    }
+
+    ///Create new entity with a name
+    Entity create_entity(std::string_view name) requires(!Registry::recycles_ids) {
+        Entity e = create_entity();
+        set<EntityName>(e, EntityName(name));
+        return e;
+    }
+
+    ///Record adding or replacing a component
+    template<typename T>
+    void set(Entity e, T data) {
+        set<T>(e, ComponentTypeID{}, std::move(data));
+    }
+
+    ///Record adding or replacing a component with variant
+    template<typename T>
+    void set(Entity e, ComponentTypeID variant_id, T data) {
+        using C = std::remove_cvref_t<T>;
+        void *payload = allocate(sizeof(C), alignof(C));
+        std::construct_at(static_cast<C *>(payload), std::move(data));
+        _commands.push_back(Command{Kind::set, e, variant_id, &type_ops<C>, payload});
+    }
+
+    ///Record construction of a component from arguments
+    template<typename T, typename ... Args>
+    void emplace(Entity e, ComponentTypeID variant_id, Args && ... args) {
+        using C = std::remove_cvref_t<T>;
+        set<C>(e, variant_id, C(std::forward<Args>(args)...));
+    }
+
+    ///Record removing a component
+    template<typename T>
+    void remove(Entity e, ComponentTypeID variant_id = {}) {
+        using C = std::remove_cvref_t<T>;
+        _commands.push_back(Command{Kind::remove, e, variant_id, &type_ops<C>, nullptr});
+    }
+
+    ///Record destroying an entity
+    void destroy_entity(Entity e) {
+        _commands.push_back(Command{Kind::destroy, e, {}, nullptr, nullptr});
+    }
+
+    ///Append commands of other buffer (after commands of this buffer)
+    /** The other buffer is left empty. Use this to collect buffers of multiple threads */
+    void merge(GenericCommandBuffer &&other) {
+        if (this == &other) return;
+        _commands.insert(_commands.end(), other._commands.begin(), other._commands.end());
+        //blocks of other buffer are only owned, allocation continues in own current block
+        for (auto &b: other._blocks) _blocks.push_back(std::move(b));
+        other._commands.clear();
+        other._blocks.clear();
+        other._current = nullptr;
+        other._block_used = 0;
+    }
+
+    ///Count of recorded commands
+    std::size_t size() const {return _commands.size();}
+    ///Returns true if no command is recorded
+    bool empty() const {return _commands.empty();}
+
+    ///Discard all commands
+    void clear() {
+        for (auto &c: _commands) {
+            if (c.payload) c.ops->discard(c.payload);
+        }
+        _commands.clear();
+        _blocks.clear();
+        _current = nullptr;
+        _block_used = 0;
+    }
+
+    ///Replay commands in the registry, the buffer is cleared
+    /** Called by GenericRegistry::apply() */
+    void replay(Registry &reg) {
+        auto cmds = std::span<Command>(_commands);
+        while (!cmds.empty()) {
+            auto barrier = std::find_if(cmds.begin(), cmds.end(), [](const Command &c){
+                return c.kind == Kind::destroy;
+            });
+            auto batch = cmds.subspan(0, static_cast<std::size_t>(barrier - cmds.begin()));
+            std::stable_sort(batch.begin(), batch.end(), [](const Command &a, const Command &b){
+                if (a.ops != b.ops) return std::less<const TypeOps *>()(a.ops, b.ops);
+                return a.variant_id < b.variant_id;
+            });
+            while (!batch.empty()) {
+                auto run_end = std::find_if(batch.begin(), batch.end(), [&](const Command &c){
+                    return c.ops != batch.front().ops || c.variant_id != batch.front().variant_id;
+                });
+                auto run = batch.subspan(0, static_cast<std::size_t>(run_end - batch.begin()));
+                run.front().ops->apply(reg, run.front().variant_id, run);
+                batch = batch.subspan(run.size());
+            }
+            if (barrier == cmds.end()) break;
+            //consecutive destroys are applied as one batch
+            auto barrier_end = std::find_if(barrier, cmds.end(), [](const Command &c){
+                return c.kind != Kind::destroy;
+            });
+            std::vector<Entity> destroyed;
+            destroyed.reserve(static_cast<std::size_t>(barrier_end - barrier));
+            std::for_each(barrier, barrier_end, [&](const Command &c){destroyed.push_back(c.entity);});
+            reg.destroy_entities(destroyed);
+            cmds = cmds.subspan(static_cast<std::size_t>(barrier_end - cmds.begin()));
+        }
+        _commands.clear();
+        _blocks.clear();
+        _current = nullptr;
+        _block_used = 0;
+    }
+
+protected:
+
+    enum class Kind {set, remove, destroy};
+
+    struct Command;
+
+    ///operations specific to the component type
+    struct TypeOps {
+        ///applies run of commands for the same pool
+        void (*apply)(Registry &reg, ComponentTypeID variant_id, std::span<Command> cmds);
+        ///destroys payload which has not been applied
+        void (*discard)(void *payload);
+    };
+
+    struct Command {
+        Kind kind;
+        Entity entity;
+        ComponentTypeID variant_id;
+        const TypeOps *ops;
+        void *payload;
+    };
+
+    template<typename T>
+    static void apply_impl(Registry &reg, ComponentTypeID variant_id, std::span<Command> cmds) {
+        //pool is looked up once for whole run
+        auto pool = reg.template find_pool<T>(variant_id);
+        auto key = Registry::template key_of<T>(variant_id);
+        auto epoch = reg.pool_epoch();
+        for (auto &c: cmds) {
+            //an observer could remove the pool
+            if (epoch != reg.pool_epoch()) {
+                pool = reg.template find_pool<T>(variant_id);
+                epoch = reg.pool_epoch();
+            }
+            if (c.kind == Kind::set) {
+                if (!pool) pool = reg.template create_component_if_needed<T>(variant_id);
+                T *v = static_cast<T *>(c.payload);
+                auto r = reg.template emplace_to_pool<T>(pool, c.entity, variant_id, std::move(*v));
+                if (r == Registry::StoreResult::rejected) {
+                    //payload has not been consumed (stale entity)
+                    discard_impl<T>(v);
+                } else {
+                    //destructive move - moved payload is not dropped
+                    std::destroy_at(v);
+                }
+                c.payload = nullptr;
+            } else if (pool) {
+                reg.remove_from_pool(*pool, c.entity, key);
+            }
+        }
+    }
+
+    template<typename T>
+    static void discard_impl(void *payload) {
+        T *v = static_cast<T *>(payload);
+        if constexpr(is_droppable<T>) drop(*v);
+        std::destroy_at(v);
+    }
+
+    template<typename T>
+    static constexpr TypeOps type_ops = {&apply_impl<T>, &discard_impl<T>};
+
+    ///size of a block of the arena
+    static constexpr std::size_t block_size = 4096;
+
+    std::vector<Command> _commands;
+    ///all blocks owned by the buffer (including merged and large blocks)
+    std::vector<std::unique_ptr<std::byte[]> > _blocks;
+    ///block where small payloads are allocated (always created by this buffer)
+    std::byte *_current = nullptr;
+    std::size_t _block_used = 0;
+
+    ///allocates space for payload in the arena
+    void *allocate(std::size_t sz, std::size_t align) {
+        if (_current) {
+            auto addr = reinterpret_cast<std::uintptr_t>(_current + _block_used);
+            std::size_t pad = (align - addr % align) % align;
+            if (_block_used + pad + sz <= block_size) {
+                void *r = _current + _block_used + pad;
+                _block_used += pad + sz;
+                return r;
+            }
+        }
+        //large payloads get own block, current block is not changed
+        std::size_t need = sz + align;
+        if (need > block_size) {
+            auto &blk = _blocks.emplace_back(std::make_unique<std::byte[]>(need));
+            void *p = blk.get();
+            std::size_t space = need;
+            return std::align(align, sz, p, space);
+        }
+        _current = _blocks.emplace_back(std::make_unique<std::byte[]>(block_size)).get();
+        _block_used = 0;
+        return allocate(sz, align);
+    }
+};
+
+}
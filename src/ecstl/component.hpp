@@ -1,7 +1,13 @@
 #pragma once
 
 #include "utils/any_ref.hpp"
+#include "utils/aggregate.hpp"
+#include "utils/change_tracked_map.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
 #include <concepts>
+#include <span>
 #include <string_view>
 #include "utils/type_name.hpp"
 
@@ -83,6 +89,82 @@ struct ComponentTraits<T> {
 template<typename T>
 constexpr auto component_type_id = ComponentTraits<std::remove_cvref_t<T> >::id;
 
+///Allocates next dense index of a component type (see component_type_index())
+inline std::size_t next_component_type_index() {
+    static std::atomic<std::size_t> counter = 0;
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+///Get dense index of a C++ component type
+/**
+ * Indexes are assigned at first use from a process wide counter, so they are small
+ * and they can be used to index an array. The index is not available at compile time
+ * and it can differ between runs
+ */
+template<typename T>
+std::size_t component_type_index() {
+    static const std::size_t idx = next_component_type_index();
+    return idx;
+}
+
+///Memory layout of a component pool
+enum class ComponentLayout {
+    ///array of structures - components are stored as whole objects (default)
+    aos,
+    ///structure of arrays - each field of the component is stored in its own array
+    soa
+};
+
+///Checks whether T requests structure of arrays layout
+/**
+ * Component requests the layout by static member
+ * @code
+ * struct Position {
+ *     static constexpr ComponentLayout component_layout = ComponentLayout::soa;
+ *     float x, y;
+ * };
+ * @endcode
+ * The component must be an aggregate without arrays and it must not be droppable.
+ */
+template<typename T>
+concept has_soa_layout = std::is_aggregate_v<T> && !is_droppable<T> && requires {
+    requires T::component_layout == ComponentLayout::soa;
+};
+
+///Checks whether T requests change tracking
+/**
+ * Component requests the tracking by static member
+ * @code
+ * struct Transform {
+ *     static constexpr bool track_changes = true;
+ *     float x, y;
+ * };
+ * @endcode
+ * Pool of such component stores ticks of insertion and of last change for each
+ * item (see ChangeTrackedMap), which allows to iterate only changed components
+ * (see View::changed_since())
+ */
+template<typename T>
+concept has_change_tracking = requires {
+    requires T::track_changes;
+};
+
+
+///Describes range of a component pool, which is grouped with other pools
+/**
+ * All pools grouped together (they have the same id) contain the same sequence
+ * of entities in their grouped range, so they can be iterated in lockstep.
+ * The range is sorted by entity id when created by group(). Owning groups keep
+ * the range at the beginning of the pool in order of insertion.
+ */
+struct PoolGroup {
+    ///id of the group, 0 - pool is not grouped with other pools
+    std::size_t id = 0;
+    ///index of first item of grouped range
+    std::size_t begin = 0;
+    ///count of items in grouped range
+    std::size_t size = 0;
+};
 
 ///Interface for component storage
 class IComponentPool {
@@ -96,10 +178,35 @@ public:
     constexpr virtual size_t size() const = 0;
     /// Retrieve entity as AnyRef if exists.
     constexpr virtual AnyRef entity(Entity e) = 0;
+    /// Retrieve position of the entity in the pool, or npos if not exists
+    constexpr virtual std::size_t index_of(Entity e) const = 0;
+    /// Swap two items at given positions
+    constexpr virtual void swap_items(std::size_t a, std::size_t b) = 0;
+    /// Retrieve grouped range of this pool
+    constexpr virtual const PoolGroup &get_group() const = 0;
+    /// Set grouped range of this pool
+    constexpr virtual void set_group(const PoolGroup &grp) = 0;
+    /// Erase the component data of all given entities (missing entities are ignored)
+    /** Batched version of erase(), the pool is crossed by one virtual call
+     * @return count of erased components */
+    constexpr virtual std::size_t erase_many(std::span<const Entity> entities) = 0;
+    /// Retrieve positions of given entities (npos for missing entities)
+    /** Batched version of index_of()
+     * @param entities entities to find
+     * @param positions receives positions, must have the same size as entities
+     * @return count of found entities */
+    constexpr virtual std::size_t index_of_many(std::span<const Entity> entities, std::span<std::size_t> positions) const = 0;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 };
 
 
 
+///Storage of a component pool, extended by ticks when the component is tracked
+template<typename T, template<class,class> class Storage>
+using ComponentStorage = std::conditional_t<has_change_tracking<T>,
+        ChangeTrackedMap<Storage<Entity, T> >, Storage<Entity, T> >;
+
 /// Generic component pool using given storage
 /**
  * T is the component type
@@ -107,9 +214,9 @@ public:
  * standard map interface (insert, find, erase, begin, end, size)
  */
 template<typename T, template<class,class> class Storage>
-class GenericComponentPool : public IComponentPool, public Storage<Entity, T>  {
+class GenericComponentPool : public IComponentPool, public ComponentStorage<T, Storage>  {
 public:
-    using Super = Storage<Entity, T>;
+    using Super = ComponentStorage<T, Storage>;
 
     ///inicialize default
     constexpr GenericComponentPool()=default;
@@ -130,9 +237,15 @@ public:
         return component_type_id<T>;
     }
     virtual constexpr void erase(Entity e)  {
+        auto iter = Super::find(e);
+        if (iter == Super::end()) return;
+        if (_group.size) {
+            //erase moves last item to the position of erased item
+            std::size_t pos = iter - Super::begin();
+            std::size_t grp_end = _group.begin + _group.size;
+            if ((pos >= _group.begin && pos < grp_end) || Super::size() <= grp_end) _group = {};
+        }
         if constexpr(is_droppable<T>) {
-            auto iter = Super::find(e);
-            if (iter == Super::end()) return;
             drop(iter->second);
         } 
         Super::erase(e);
@@ -144,8 +257,59 @@ public:
     virtual AnyRef entity(Entity e) {
         auto iter = Super::find(e);
         if (iter == Super::end()) return AnyRef{};
+        //structure of arrays doesn't store component as an object
+        if constexpr(is_soa_ref<decltype(iter->second)>) return AnyRef{};
         else return AnyRef(iter->second);
     }    
+
+    virtual constexpr std::size_t index_of(Entity e) const {
+        auto iter = Super::find(e);
+        if (iter == Super::end()) return IComponentPool::npos;
+        return iter - Super::begin();
+    }
+    virtual constexpr void swap_items(std::size_t a, std::size_t b) {
+        Super::swap_items(a, b);
+    }
+    virtual constexpr const PoolGroup &get_group() const {return _group;}
+    virtual constexpr void set_group(const PoolGroup &grp) {_group = grp;}
+    virtual constexpr std::size_t erase_many(std::span<const Entity> entities) {
+        if (entities.size() == 1) {
+            std::size_t cnt = Super::size();
+            GenericComponentPool::erase(entities.front());
+            return cnt - Super::size();
+        }
+        std::vector<std::size_t> positions;
+        positions.reserve(entities.size());
+        for (const Entity &e: entities) {
+            auto iter = Super::find(e);
+            if (iter != Super::end()) positions.push_back(iter - Super::begin());
+        }
+        if (positions.empty()) return 0;
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        if (_group.size) {
+            //items of the group are erased or moved
+            std::size_t grp_end = _group.begin + _group.size;
+            auto first = std::lower_bound(positions.begin(), positions.end(), _group.begin);
+            if ((first != positions.end() && *first < grp_end) || Super::size() - positions.size() < grp_end) _group = {};
+        }
+        if constexpr(is_droppable<T>) {
+            for (std::size_t pos: positions) drop((Super::begin() + pos)->second);
+        }
+        Super::erase_at(positions);
+        return positions.size();
+    }
+    virtual constexpr std::size_t index_of_many(std::span<const Entity> entities, std::span<std::size_t> positions) const {
+        std::size_t cnt = 0;
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            positions[i] = GenericComponentPool::index_of(entities[i]);
+            cnt += positions[i] != IComponentPool::npos;
+        }
+        return cnt;
+    }
+
+protected:
+    PoolGroup _group;
 };
 
 
@@ -2,6 +2,8 @@
 #include "entity.hpp"
 #include "component.hpp"
 #include "registry.hpp"
+#include "command_buffer.hpp"
+#include "query.hpp"
 #include "utils/indexed_flat_map.hpp"
 #include <typeinfo>
 #include <memory>
@@ -12,6 +14,10 @@ namespace ecstl {
 
 
 using Registry = GenericRegistry<>;
+///Registry which recycles ids of destroyed entities
+using RegistryRecycling = GenericRegistry<RecyclingRegistryTraits>;
+///Registry which emits lifecycle signals of components
+using RegistrySignaling = GenericRegistry<SignalingRegistryTraits>;
 
 
 }
\ No newline at end of file
@@ -2,12 +2,15 @@
 #include <cstdint>
 #include <atomic>
 #include <compare>
+#include <iterator>
 #include <source_location>
 #include "polyfill/hasher.hpp"
 
 
 namespace ecstl {
 
+class EntityRange;
+
 /// An entity identifier
 /** Entities are identified by a unique integer ID */
 class Entity {
@@ -22,18 +25,53 @@ public:
      * This constructor is mainly used internally to create entities with a specific ID.
      * It also ensures that the ID generator is updated to avoid ID collisions.
      * Useful for deserialization or cloning entities.
+     *
+     * If the id falls into the block of the calling thread (see create()), the block
+     * is advanced past it. Blocks held by other threads can't be reached, so constructing
+     * ids while other threads create entities is not supported (ids may collide)
      */
     Entity(std::uint64_t id):_id(id) {
         auto r = _idgen.load();
-        while (id > r && !_idgen.compare_exchange_weak(r, id));        
+        while (id > r && !_idgen.compare_exchange_weak(r, id));
+        IdBlock &blk = _local_block;
+        if (id >= blk.next && id < blk.end) blk.next = id + 1;
     }
     consteval Entity(std::uint64_t id, is_const_eval):_id(id) {};
 
+    /// Wrap an existing id
+    /**
+     * Unlike the constructor, this doesn't touch the ID generator. Use it for ids
+     * which were already created (for example ids passed back through the C API)
+     */
+    static constexpr Entity from_id(std::uint64_t id) {
+        return Entity(id, reserved_id{});
+    }
+
+    /// Count of ids reserved by a thread at once (see create())
+    static constexpr std::size_t id_block_size = 256;
+
     /// Create a new unique entity
-    static Entity create()  {        
-        return Entity(_idgen.fetch_add(1)+1);
+    /**
+     * Ids are taken from a block owned by the calling thread. The shared ID generator
+     * is touched only once per id_block_size entities. Ids are unique, but entities
+     * created by different threads are not ordered by their creation time
+     */
+    static Entity create()  {
+        IdBlock &blk = _local_block;
+        if (blk.next == blk.end) {
+            blk.next = _idgen.fetch_add(id_block_size)+1;
+            blk.end = blk.next + id_block_size;
+        }
+        return Entity(blk.next++, reserved_id{});
     }
 
+    /// Create contiguous range of new unique entities
+    /**
+     * @param count count of entities
+     * @return range of entities. Ids are reserved by single atomic operation
+     */
+    static EntityRange create_range(std::size_t count);
+
     static consteval Entity create_consteval(std::source_location loc = std::source_location::current()) {
         hash<std::string_view> get_hash;
         std::uint64_t idgen = 1 + get_hash(loc.file_name()) + loc.line() + (std::uint64_t(loc.column()) << 16);
@@ -54,14 +92,97 @@ public:
     }
 
     std::size_t id() const {return _id;}
+
+    /// Count of low bits of the id which carry the index of the entity
+    static constexpr unsigned int index_bits = 40;
+    /// Mask of the index part of the id
+    static constexpr std::uint64_t index_mask = (std::uint64_t(1) << index_bits) - 1;
+    /// Highest generation which fits to the id
+    static constexpr std::uint64_t max_generation = (~std::uint64_t(0)) >> index_bits;
+
+    /// Index part of the id
+    /** Ids created by Entity::create() have generation 0, so the index is the id itself */
+    constexpr std::uint64_t index() const {return _id & index_mask;}
+    /// Generation part of the id (incremented each time the index is recycled, see EntityManager)
+    constexpr std::uint64_t generation() const {return _id >> index_bits;}
+    /// Compose entity from index and generation (doesn't touch the ID generator)
+    static constexpr Entity from_parts(std::uint64_t index, std::uint64_t generation) {
+        return from_id((generation << index_bits) | (index & index_mask));
+    }
 protected:
     std::size_t _id;
     static std::atomic<std::size_t> _idgen;
 
+    struct IdBlock {
+        std::size_t next = 0;
+        std::size_t end = 0;
+    };
+    static thread_local IdBlock _local_block;
+
+    struct reserved_id {};
+    /// Construct entity from id already reserved in the generator
+    constexpr Entity(std::uint64_t id, reserved_id):_id(id) {}
+
+    friend class EntityRange;
 };
 
+/// Contiguous range of entities (see Entity::create_range)
+class EntityRange {
+public:
+
+    class iterator {
+    public:
+        using value_type = Entity;
+        using reference = Entity;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(std::size_t id):_id(id) {}
+
+        constexpr Entity operator*() const {return Entity(_id, Entity::reserved_id{});}
+        constexpr Entity operator[](difference_type n) const {return *(*this + n);}
+        constexpr iterator &operator++() {++_id; return *this;}
+        constexpr iterator &operator--() {--_id; return *this;}
+        constexpr iterator operator++(int) {auto r = *this; ++_id; return r;}
+        constexpr iterator operator--(int) {auto r = *this; --_id; return r;}
+        constexpr iterator &operator+=(difference_type n) {_id += n; return *this;}
+        constexpr iterator &operator-=(difference_type n) {_id -= n; return *this;}
+        constexpr iterator operator+(difference_type n) const {return iterator(_id + n);}
+        constexpr iterator operator-(difference_type n) const {return iterator(_id - n);}
+        friend constexpr iterator operator+(difference_type n, const iterator &it) {return it + n;}
+        constexpr difference_type operator-(const iterator &other) const {
+            return static_cast<difference_type>(_id - other._id);
+        }
+        constexpr bool operator==(const iterator &) const = default;
+        constexpr auto operator<=>(const iterator &) const = default;
+
+    protected:
+        std::size_t _id = 0;
+    };
+
+    constexpr EntityRange() = default;
+    constexpr EntityRange(std::size_t first_id, std::size_t count):_first(first_id), _count(count) {}
+
+    constexpr iterator begin() const {return iterator(_first);}
+    constexpr iterator end() const {return iterator(_first + _count);}
+    constexpr std::size_t size() const {return _count;}
+    constexpr bool empty() const {return _count == 0;}
+    constexpr Entity operator[](std::size_t idx) const {return begin()[static_cast<std::ptrdiff_t>(idx)];}
+
+protected:
+    std::size_t _first = 0;
+    std::size_t _count = 0;
+};
+
+inline EntityRange Entity::create_range(std::size_t count) {
+    return EntityRange(_idgen.fetch_add(count)+1, count);
+}
+
 
 inline std::atomic<std::size_t> Entity::_idgen;
+inline thread_local Entity::IdBlock Entity::_local_block;
 
 
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include "entity.hpp"
+#include <vector>
+#include <cstdint>
+
+namespace ecstl {
+
+///Allocates entity ids and recycles ids of destroyed entities
+/**
+ * The id of an entity consists of an index and a generation (see Entity::index()).
+ * When an entity is destroyed, its index is returned to a free list and its
+ * generation is incremented. The next created entity reuses the index with the new
+ * generation. Indices stay small, so id-indexed storage (sparse sets) doesn't grow
+ * with churn, and handles of destroyed entities are detected by is_alive().
+ *
+ * An index whose generation reaches Entity::max_generation is retired and never reused.
+ *
+ * @note The manager is not thread safe. Indices are local to the manager, so
+ * don't mix its entities with entities created by Entity::create()
+ */
+class EntityManager {
+public:
+
+    constexpr EntityManager() = default;
+
+    ///Create new entity (reuses freed index if available)
+    constexpr Entity create() {
+        std::uint64_t idx;
+        if (!_free.empty()) {
+            idx = _free.back();
+            _free.pop_back();
+        } else {
+            idx = _slots.size();
+            _slots.push_back({});
+        }
+        Slot &s = _slots[idx];
+        s.alive = true;
+        ++_alive;
+        return Entity::from_parts(idx + 1, s.generation);
+    }
+
+    ///Create contiguous range of new entities
+    /** The range always uses fresh indices (the free list is not used) */
+    constexpr EntityRange create_range(std::size_t count) {
+        std::size_t first = _slots.size();
+        _slots.resize(first + count, Slot{0, true});
+        _alive += count;
+        return EntityRange(first + 1, count);
+    }
+
+    ///Destroy entity
+    /**
+     * @param e entity
+     * @retval true destroyed, index is returned for reuse
+     * @retval false entity is not alive (already destroyed or unknown)
+     */
+    constexpr bool destroy(Entity e) {
+        if (!is_alive(e)) return false;
+        Slot &s = _slots[e.index() - 1];
+        s.alive = false;
+        --_alive;
+        if (s.generation < Entity::max_generation) {
+            ++s.generation;
+            _free.push_back(e.index() - 1);
+        }
+        return true;
+    }
+
+    ///Returns true if the entity was created by this manager and not destroyed yet
+    constexpr bool is_alive(Entity e) const {
+        std::uint64_t idx = e.index();
+        if (idx == 0 || idx > _slots.size()) return false;
+        const Slot &s = _slots[idx - 1];
+        return s.alive && s.generation == e.generation();
+    }
+
+    ///Count of alive entities
+    constexpr std::size_t size() const {return _alive;}
+
+    ///Count of allocated indices (alive and free)
+    constexpr std::size_t capacity() const {return _slots.size();}
+
+protected:
+    struct Slot {
+        std::uint64_t generation = 0;
+        bool alive = false;
+    };
+
+    //index 0 is reserved for null entity, slot n belongs to index n+1
+    std::vector<Slot> _slots;
+    std::vector<std::uint64_t> _free;
+    std::size_t _alive = 0;
+};
+
+}
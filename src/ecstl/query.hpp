@@ -0,0 +1,78 @@
+#pragma once
+#include "registry.hpp"
+#include <array>
+#include <optional>
+#include <span>
+
+namespace ecstl {
+
+///View whose pools are resolved once and reused
+/**
+ * GenericRegistry::view() looks up every pool in the registry. The query keeps the
+ * view and looks up the pools again only when the list of pools of the registry
+ * changes (see GenericRegistry::pool_epoch()), so repeated iteration (once per frame)
+ * costs a single comparison.
+ *
+ * @tparam Registry type of registry (use GenericRegistry::Query)
+ * @tparam Components same as GenericRegistry::view(), including Exclude and Optional
+ *
+ * @code
+ * Registry::Query<Position, const Velocity> moving(reg);
+ * for (auto [e, p, v]: moving) {...}
+ * @endcode
+ *
+ * @note the query refers to the registry, the registry must outlive the query
+ */
+template<typename Registry, typename ... Components>
+class GenericQuery {
+public:
+
+    ///Type of the cached view
+    using ViewType = decltype(std::declval<const Registry &>().template view<Components...>(std::span<const ComponentTypeID>()));
+
+    ///Create query
+    /**
+     * @param reg registry
+     * @param ids variant ids (same as GenericRegistry::view())
+     */
+    constexpr GenericQuery(const Registry &reg, std::span<const ComponentTypeID> ids = {})
+        :_reg(&reg) {
+        _ids_count = std::min(ids.size(), _ids.size());
+        std::copy(ids.begin(), ids.begin() + _ids_count, _ids.begin());
+    }
+
+    constexpr GenericQuery(const Registry &reg, std::initializer_list<ComponentTypeID> ids)
+        :GenericQuery(reg, std::span<const ComponentTypeID>(ids)) {}
+
+    ///Retrieve the view, pools are resolved again if they changed
+    constexpr const ViewType &view() {
+        if (!_view || _epoch != _reg->pool_epoch()) {
+            _view.reset();
+            _view.emplace(_reg->template view<Components...>(std::span<const ComponentTypeID>(_ids.data(), _ids_count)));
+            _epoch = _reg->pool_epoch();
+        }
+        return *_view;
+    }
+
+    constexpr auto begin() {return view().begin();}
+    constexpr auto end() {return view().end();}
+
+    ///Returns true if cached pools are still valid
+    constexpr bool is_valid() const {
+        return _view && _epoch == _reg->pool_epoch();
+    }
+
+    ///Discard cached pools, they are resolved again on next access
+    constexpr void invalidate() {
+        _view.reset();
+    }
+
+protected:
+    const Registry *_reg;
+    std::array<ComponentTypeID, sizeof...(Components)> _ids = {};
+    std::size_t _ids_count = 0;
+    std::size_t _epoch = 0;
+    std::optional<ViewType> _view;
+};
+
+}
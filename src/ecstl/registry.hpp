@@ -1,9 +1,12 @@
 #pragma once
 
 #include "component.hpp"
+#include "entity_manager.hpp"
 #include "utils/optional_ref.hpp"
 #include "view.hpp"
+#include "signals.hpp"
 #include "utils/indexed_flat_map.hpp"
+#include "utils/soa_flat_map.hpp"
 
 #include <string>
 #include <concepts>
@@ -11,6 +14,9 @@
 #include <memory>
 #include <algorithm>
 #include <vector>
+#include <variant>
+#include <ranges>
+#include <mutex>
 #include "polyfill/unique_ptr.hpp"
 
 namespace ecstl {
@@ -48,6 +54,11 @@ public:
         delete [] _name;                
     }
 
+    ///Create independent copy of the name (copy constructor makes shallow copy)
+    constexpr EntityName clone() const {
+        return EntityName(static_cast<std::string_view>(*this));
+    }
+
 protected:
     char *_name = nullptr;
     std::size_t _size = 0;
@@ -62,6 +73,25 @@ concept ComponentVisitor = std::is_invocable_v<T, AnyRef>
 
 
 
+///Lifecycle signals of a component pool
+/**
+ * Observers receive the entity. on_construct and on_update are emitted after the
+ * component is stored, on_destroy is emitted before the component is removed, so a
+ * synchronous observer can still read it.
+ *
+ * @tparam Dispatcher dispatcher of the signals (see SignalSlot)
+ */
+template<typename Dispatcher>
+struct ComponentSignals {
+    using Signal = SignalSlot<void(Entity), Dispatcher>;
+    ///component has been added
+    Signal on_construct;
+    ///component has been replaced by set() or emplace()
+    Signal on_update;
+    ///component is going to be removed
+    Signal on_destroy;
+};
+
 ///Default registry traist (for singlethreading)
 struct DefaultRegistryTraits {
 
@@ -71,6 +101,10 @@ struct DefaultRegistryTraits {
     template<typename K, typename V>
     class RegistryStorage: public OpenHashMap<K, V, HashOfKey<K>, std::equal_to<K> > {};
 
+    ///storage of components which request ComponentLayout::soa
+    template<typename K, typename V>
+    class SoaPoolStorage: public SoaFlatMap<K, V, HashOfKey<K>, std::equal_to<K> > {};
+
 
 
 
@@ -82,8 +116,12 @@ struct DefaultRegistryTraits {
 
     
     ///type which specifies type used to store components of T
+    /** Components with ComponentLayout::soa are stored in SoaPoolStorage. Their
+     * pools return soa_ref proxies instead of references */
     template<typename T>
-    using ComponentPool = GenericComponentPool<ComponentNormalized<T>, PoolStorage>;   
+    using ComponentPool = std::conditional_t<has_soa_layout<ComponentNormalized<T> >,
+                            GenericComponentPool<ComponentNormalized<T>, SoaPoolStorage>,
+                            GenericComponentPool<ComponentNormalized<T>, PoolStorage> >;
 
     ///smart pointer to hold abstract component pool
     using PoolSmartPtr = unique_ptr<IComponentPool>;
@@ -137,9 +175,86 @@ struct DefaultRegistryTraits {
     static constexpr Ref<T> create_ref() {
         return Ref<T>(std::nullopt);
     }
+
+    ///Enables per-entity component signature
+    /**
+     * When enabled, the registry keeps a list of pools for every entity. Then
+     * destroy_entity(), is_known() and for_each_component() visit only pools
+     * where the entity actually lives, instead of scanning all pools.
+     *
+     * @note components must be added and removed through the registry API. Direct
+     * modification of a pool (obtained by create_component_pool()) is not tracked
+     */
+    static constexpr bool track_entity_components = false;
+
+    ///Enables recycling of entity ids
+    /**
+     * When enabled, the registry allocates entities by its own EntityManager. Ids of
+     * destroyed entities are reused with incremented generation, so ids stay small
+     * and is_alive() detects stale handles.
+     *
+     * @note entities must be created by the registry (create_entity()), not by Entity::create()
+     */
+    static constexpr bool recycle_entity_ids = false;
+
+    ///Enables locking of component pools
+    /**
+     * When enabled, the traits must provide lock_pool<T>(ptr) (returns lock of the
+     * pool, shared for const T, exclusive otherwise), lock_pool_exclusive(IComponentPool &)
+     * and create_ref<T>(data, ptr, lock). See ConcurrentRegistryTraits
+     */
+    static constexpr bool lock_component_pools = false;
+
+    ///Enables copy on write of component pools
+    /**
+     * When enabled, GenericRegistry::snapshot() creates a read-only copy of the
+     * registry which shares all pools. A shared pool is copied before it is modified.
+     * The traits must provide share_pool(PoolSmartPtr &) and detach_pool(PoolSmartPtr &).
+     * See CopyOnWriteRegistryTraits
+     */
+    static constexpr bool copy_on_write_pools = false;
+
+    ///Enables lifecycle signals of component pools
+    /**
+     * When enabled, GenericRegistry::on_construct(), on_update() and on_destroy() return
+     * signal slots of a pool (see ComponentSignals), which are dispatched by SignalDispatcher
+     */
+    static constexpr bool emit_component_signals = false;
+
+    ///Dispatcher of lifecycle signals (when enabled)
+    using SignalDispatcher = SyncSignalDispatcher;
     
 };
 
+///Registry traits with enabled per-entity component signature
+/**
+ * Useful when there are many component types and entities are often destroyed.
+ * Each entity carries list of its pools, so destroy_entity() doesn't need to
+ * scan all pools. Costs an extra lookup on every add or remove of a component
+ */
+struct TrackedRegistryTraits: DefaultRegistryTraits {
+    static constexpr bool track_entity_components = true;
+};
+
+///Registry traits with lifecycle signals of component pools
+/**
+ * Useful to keep external structures (spatial indexes, caches) in sync with the
+ * registry. When nobody connected to signals of a pool, the cost is a lookup of
+ * an empty map
+ */
+struct SignalingRegistryTraits: DefaultRegistryTraits {
+    static constexpr bool emit_component_signals = true;
+};
+
+///Registry traits with recycling of entity ids
+/**
+ * Useful for long running processes which create and destroy many entities.
+ * Each registry has own EntityManager, destroyed ids are reused with new generation
+ */
+struct RecyclingRegistryTraits: DefaultRegistryTraits {
+    static constexpr bool recycle_entity_ids = true;
+};
+
 struct ConceptTestComponent {};
 
 template<typename T>
@@ -164,9 +279,49 @@ concept RegistryTraits = requires {
 };
 
 static_assert(RegistryTraits<DefaultRegistryTraits>);
+static_assert(RegistryTraits<TrackedRegistryTraits>);
+static_assert(RegistryTraits<RecyclingRegistryTraits>);
+static_assert(RegistryTraits<SignalingRegistryTraits>);
+
+///Determines whether registry traits enables per-entity component signature
+template<typename Traits>
+constexpr bool tracks_entity_components = requires {
+    requires Traits::track_entity_components;
+};
 
+///Determines whether registry traits enables locking of component pools
+template<typename Traits>
+constexpr bool locks_component_pools = requires {
+    requires Traits::lock_component_pools;
+};
 
+///Determines whether registry traits enables copy on write of component pools
+template<typename Traits>
+constexpr bool copies_pools_on_write = requires {
+    requires Traits::copy_on_write_pools;
+};
 
+///Determines whether registry traits enables lifecycle signals of component pools
+template<typename Traits>
+constexpr bool emits_component_signals = requires {
+    requires Traits::emit_component_signals;
+    typename Traits::SignalDispatcher;
+};
+
+///Determines whether registry traits enables recycling of entity ids
+template<typename Traits>
+constexpr bool recycles_entity_ids = requires {
+    requires Traits::recycle_entity_ids;
+};
+
+
+
+
+template<typename Registry>
+class GenericCommandBuffer;
+
+template<typename Registry, typename ... Components>
+class GenericQuery;
 
 ///GenericRegistry class template
 /**
@@ -188,6 +343,25 @@ public:
     using PoolType = typename Traits::template ComponentPool<T>;
     template<typename T> 
     using PoolPtr = typename Traits::template ComponentPoolPtr<T>;
+    template<typename T> 
+    using ComponentType = typename Traits::template ComponentNormalized<T>;
+
+    ///Buffer of deferred changes (include command_buffer.hpp)
+    using CommandBuffer = GenericCommandBuffer<GenericRegistry>;
+
+    ///View with cached pools (include query.hpp)
+    template<typename ... Components>
+    using Query = GenericQuery<GenericRegistry, Components...>;
+
+    ///true if the registry recycles entity ids (see DefaultRegistryTraits::recycle_entity_ids)
+    static constexpr bool recycles_ids = recycles_entity_ids<Traits>;
+
+    ///true if pools of C++ component types are also indexed by component_type_index()
+    /**
+     * Pools of the default variant are then found by an array lookup instead of
+     * the hash map. Requires traits which use raw pointers to pools
+     */
+    static constexpr bool indexes_pools = std::is_pointer_v<typename Traits::template ComponentPoolPtr<EntityName> >;
 
     constexpr GenericRegistry() = default;
 
@@ -212,10 +386,42 @@ public:
 
     using Storage = typename Traits::template RegistryStorage<Key, PPool>;
 
+    ///List of pools where an entity lives (when signature is tracked)
+    using Signature = std::vector<Key>;
+
+    ///Storage of signatures, it is empty when signatures are not tracked
+    using SignatureStorage = std::conditional_t<tracks_entity_components<Traits>,
+                typename Traits::template RegistryStorage<Entity, Signature>, std::monostate>;
+
+
+    ///Storage of entity ids, it is empty when ids are not recycled
+    using EntityStorage = std::conditional_t<recycles_ids, EntityManager, std::monostate>;
+
+    ///Lifecycle signals of a pool (when enabled)
+    using Signals = ComponentSignals<typename std::conditional_t<emits_component_signals<Traits>,
+                Traits, DefaultRegistryTraits>::SignalDispatcher>;
+
+    ///Pool registered in the dense index (see indexes_pools)
+    struct IndexedPool {
+        ComponentTypeID _type_id;
+        IComponentPool *_pool = nullptr;
+    };
+
+    ///Dense index of pools, it is empty when pools are not indexed
+    using PoolIndex = std::conditional_t<indexes_pools, std::vector<IndexedPool>, std::monostate>;
+
+    ///Storage of signals, it is empty when signals are not enabled
+    using SignalStorage = std::conditional_t<emits_component_signals<Traits>,
+                typename Traits::template RegistryStorage<Key, std::shared_ptr<Signals> >, std::monostate>;
 
     ///Create a new entity
-    static constexpr Entity create_entity() {
-        return Entity::create();
+    /** When the registry recycles ids, the id of a destroyed entity can be reused */
+    constexpr Entity create_entity() {
+        if constexpr(recycles_ids) {
+            return _entities.create();
+        } else {
+            return Entity::create();
+        }
     }
 
     ///Create a new entity with a name
@@ -229,15 +435,161 @@ public:
         return e;
     }
 
+    ///Create multiple entities at once
+    /** @param count count of entities
+     *  @return contiguous range of new entities. Ids are reserved by single
+     *  atomic operation, so this is cheaper than calling create_entity() in a loop
+     */
+    constexpr EntityRange create_entities(std::size_t count) {
+        if constexpr(recycles_ids) {
+            return _entities.create_range(count);
+        } else {
+            return Entity::create_range(count);
+        }
+    }
+
+    ///Check whether the entity has not been destroyed
+    /**
+     * @param e entity
+     * @return when the registry recycles ids, returns true if the entity was created
+     * by this registry and not destroyed yet (handles of destroyed entities are detected
+     * by generation). Otherwise it is the same as is_known()
+     */
+    constexpr bool is_alive(Entity e) const {
+        if constexpr(recycles_ids) {
+            return _entities.is_alive(e);
+        } else {
+            return is_known(e);
+        }
+    }
+
+    ///Retrieve current value of the change counter
+    /**
+     * Components which track changes (see has_change_tracking) are stamped by this
+     * value when they are added (emplace(), set()), retrieved for writing (non-const get())
+     * or marked by mark_dirty(). The counter starts at 1.
+     */
+    constexpr ChangeTick current_tick() const {return _tick;}
+
+    ///Increment the change counter
+    /**
+     * @return new value of the counter. Store it to find changes made from now on, for
+     * example: `auto since = reg.advance_tick();` at the end of a frame, then
+     * `view<T>().changed_since(since)` in the next frame
+     */
+    constexpr ChangeTick advance_tick() {return ++_tick;}
+
+    ///Mark component as changed by current tick
+    /** Use after a component was modified through a view or through a reference
+     *  retrieved earlier. Has no effect if the component doesn't track changes
+     *  @param e entity
+     *  @param variant_id component variant
+     *  @retval true component found
+     *  @retval false component not found
+     */
+    template<typename T>
+    constexpr bool mark_dirty(Entity e, ComponentTypeID variant_id = {}) {
+        auto p = find_pool<std::remove_cvref_t<T> >(variant_id);
+        if (!p) return false;
+        [[maybe_unused]] auto lk = lock_for_write<std::remove_cvref_t<T> >(p);
+        auto iter = p->find(e);
+        if (iter == p->end()) return false;
+        stamp(*p, iter, false);
+        return true;
+    }
+
+    ///Retrieve signal emitted when a component of type T is added
+    /** Available when the traits enable signals (see SignalingRegistryTraits)
+     *  @param variant_id component variant
+     *  @return signal slot, connect observers by connect(slot, fn). The slot
+     *  lives as long as the registry
+     */
+    template<typename T>
+    auto &on_construct(ComponentTypeID variant_id = {}) requires(emits_component_signals<Traits>) {
+        return signals_of(key_of<T>(variant_id)).on_construct;
+    }
+
+    ///Retrieve signal emitted when a component of type T is replaced by set() or emplace()
+    /** @see on_construct */
+    template<typename T>
+    auto &on_update(ComponentTypeID variant_id = {}) requires(emits_component_signals<Traits>) {
+        return signals_of(key_of<T>(variant_id)).on_update;
+    }
+
+    ///Retrieve signal emitted before a component of type T is removed
+    /** Emitted by remove(), remove_all_of() and destroy_entity()
+     *  @see on_construct */
+    template<typename T>
+    auto &on_destroy(ComponentTypeID variant_id = {}) requires(emits_component_signals<Traits>) {
+        return signals_of(key_of<T>(variant_id)).on_destroy;
+    }
+
     ///Destroy an entity and all its components
     /**
      * @param entity Entity to be destroyed
      * This removes all components associated with the entity.
      */
     constexpr void destroy_entity(Entity entity) {
-        for (auto &[k,v]: _storage) {
-            v->erase(entity);
+        if constexpr(recycles_ids) {
+            //stale handle - its index can belong to other entity now
+            if (!_entities.destroy(entity)) return;
         }
+        erase_entities(std::span<const Entity>(&entity, 1));
+    }
+
+    ///Destroy many entities and all their components
+    /**
+     * @param entities entities to be destroyed, each entity should be listed once
+     *
+     * Every pool is visited once for whole batch. Components are erased by one pass
+     * over the dense arrays of the pool, the holes are filled from the end of the pool
+     * and the index is updated only for moved components. This is faster than calling
+     * destroy_entity() for each entity
+     */
+    constexpr void destroy_entities(std::span<const Entity> entities) {
+        if constexpr(recycles_ids) {
+            //skip stale handles
+            std::vector<Entity> alive;
+            alive.reserve(entities.size());
+            for (Entity e: entities) {
+                if (_entities.destroy(e)) alive.push_back(e);
+            }
+            erase_entities(alive);
+        } else {
+            erase_entities(entities);
+        }
+    }
+
+    ///Create read-only snapshot of the registry
+    /**
+     * Available when the traits copy pools on write (see CopyOnWriteRegistryTraits).
+     * The snapshot shares all pools with this registry, nothing is copied now. When a
+     * shared pool is about to be modified (set, remove, non-const get, view, ...), the
+     * modifying registry copies it first. So the snapshot sees consistent state and it
+     * can be read from other thread without locks, while this registry copies only
+     * pools which are actually modified.
+     *
+     * @return snapshot. Access components as const (get<const T>, view<const T>),
+     * non-const access makes private copy of the pool in the snapshot
+     *
+     * @note don't create a snapshot while a non-const view of this registry is iterated
+     */
+    std::shared_ptr<const GenericRegistry> snapshot() requires(copies_pools_on_write<Traits>) {
+        for (auto &[k, v]: _storage) Traits::share_pool(v);
+        //pools must be detached before next write, cached queries must resolve them again
+        ++_pool_epoch;
+        return std::make_shared<GenericRegistry>(*this);
+    }
+
+    ///Apply changes recorded in a command buffer
+    /**
+     * @param buffer command buffer, it is cleared by the operation
+     *
+     * The commands are applied grouped by pool, see GenericCommandBuffer. Don't call
+     * this function while a view of this registry is being iterated
+     */
+    void apply(CommandBuffer &&buffer) {
+        buffer.replay(*this);
     }
 
     ///Get the name of an entity (if it has EntityName component)
@@ -245,7 +597,7 @@ public:
      *  @return Name of the entity or empty string_view if not set
      */
     constexpr std::string_view get_entity_name(Entity entity) const {
-        auto c = get<EntityName>(entity);
+        auto c = get<const EntityName>(entity);
         if (c) return c.value();
         else return {};
     }
@@ -293,44 +645,81 @@ public:
      *          Arg0 is treated as the first argument for component construction.
      *  @param args Arguments for constructing the component
      *  @retval true component has been created
-     *  @retval false component has been replaced
+     *  @retval false component has been replaced, or the entity is not alive (handle
+     *  of destroyed entity when the registry recycles ids), then nothing is stored
      */
     template<typename T, typename Arg0, typename ... Args>
     constexpr bool emplace(Entity e, Arg0 &&variant_id, Args && ... args) {
         if constexpr(std::is_same_v<std::decay_t<Arg0>, ComponentTypeID>) {
-            auto p = create_component_if_needed<T>(variant_id);
-            auto r = p->try_emplace(e, std::forward<Args>(args)...);
-            if (!r.second) {
-                if constexpr(is_droppable<decltype(r.first->second)>) {
-                    drop(r.first->second);
-                }
-                std::destroy_at(std::addressof(r.first->second));
-                std::construct_at(std::addressof(r.first->second), std::forward<Args>(args)...);
-                return false;
-            }
-            return true;
+            return emplace_to_pool<T>(create_component_if_needed<T>(variant_id), e, variant_id, std::forward<Args>(args)...)
+                    == StoreResult::created;
         } else {
-            return emplace(e, ComponentTypeID{}, std::forward<Arg0>(variant_id), std::forward<Args>(args)...);
+            return emplace<T>(e, ComponentTypeID{}, std::forward<Arg0>(variant_id), std::forward<Args>(args)...);
         }
     }
 
     ///Add a component for an entity with default component variant ID (0)
     /** @tparam T Type of the component to be added. Extra qualifiers are removed.
      *  @param e Entity to which the component is to be added
-     *  @return Reference to the component data stored in the registry
+     *  @return Ref to the component data stored in the registry (std::optional with soa_ref proxy
+     *  for components with ComponentLayout::soa), see get(). The Ref is empty when nothing has been
+     *  stored (the entity is not alive)
      * This overload uses default component variant ID (0).
      * 
      * This overload is just special case of the above emplace() method with default variant ID.
      */
     template<typename T>
-    constexpr T &emplace(Entity e) {
-        PoolType<T> *p = create_component_if_needed<T>({});
-        auto r = p->try_emplace(e);
-        if (!r.second) {
-            std::destroy_at(std::addressof(r.first->second));
-            std::construct_at(std::addressof(r.first->second));
+    constexpr auto emplace(Entity e) {
+        auto p = create_component_if_needed<T>({});
+        emplace_to_pool<T>(p, e, {});
+        //component could be moved to grouped range, so it is looked up again
+        return get<ComponentType<T> >(e);
+    }
+
+    ///Add or replace components of many entities in one pass
+    /** @tparam T Type of the component. Extra qualifiers are removed.
+     *  @param entities range of entities
+     *  @param values range of values, n-th value is assigned to n-th entity. Values are
+     *  moved if the range is passed as rvalue, otherwise they are copied
+     *  @param variant_id component variant ID
+     *  @return count of newly created components (replaced components are not counted)
+     *
+     *  The pool is looked up once. If the size of the range is known and the pool
+     *  can't hold all new items, it is grown once before they are inserted (at least twice
+     *  of its capacity, so repeated small batches don't reallocate every time)
+     */
+    template<typename T, std::ranges::input_range Entities, std::ranges::input_range Values>
+    constexpr std::size_t emplace_bulk(Entities &&entities, Values &&values, ComponentTypeID variant_id = {}) {
+        auto p = create_component_if_needed<T>(variant_id);
+        if constexpr(std::ranges::sized_range<Entities> && requires{p->reserve(std::size_t()); p->capacity();}) {
+            //reallocation must not run under readers of the pool
+            [[maybe_unused]] auto lk = lock_for_write<T>(p);
+            std::size_t need = p->size() + std::ranges::size(entities);
+            if (need > p->capacity()) p->reserve(std::max(need, 2 * p->capacity()));
+        }
+        std::size_t created = 0;
+        [[maybe_unused]] auto epoch = _pool_epoch;
+        auto v = std::ranges::begin(values);
+        auto ve = std::ranges::end(values);
+        for (Entity e: entities) {
+            if (v == ve) break;
+            StoreResult r;
+            if constexpr(std::is_lvalue_reference_v<Values>) {
+                r = emplace_to_pool<T>(p, e, variant_id, *v);
+            } else {
+                r = emplace_to_pool<T>(p, e, variant_id, std::move(*v));
+            }
+            created += r == StoreResult::created?1:0;
+            ++v;
+            if constexpr(emits_component_signals<Traits>) {
+                //an observer could remove the pool
+                if (epoch != _pool_epoch) {
+                    p = create_component_if_needed<T>(variant_id);
+                    epoch = _pool_epoch;
+                }
+            }
         }
-        return r.first->second;        
+        return created;
     }
 
     ///Remove a component of type T with specific component variant ID from an entity (if it exists)
@@ -340,27 +729,77 @@ public:
      */
     template<typename T>
     constexpr void remove(Entity e, ComponentTypeID variant_id = {}) {
-        auto iter = _storage.find(Key{Traits::template component_type_id<T>, variant_id});
-        if (iter == _storage.end()) return;
-        iter->second->erase(e);
+        auto p = find_pool<ComponentType<T> >(variant_id);
+        if (!p) return;
+        remove_from_pool(*p, e, key_of<T>(variant_id));
+    }
+
+    ///Remove a component of type T from many entities
+    /** @tparam T Type of the component to be removed. Note extra qualifiers are removed.
+     *  @param entities entities from which the component is to be removed
+     *  @param variant_id component variant ID
+     *  @return count of removed components
+     *
+     *  The pool is looked up once and the components are erased in one pass (see destroy_entities())
+     */
+    template<typename T>
+    constexpr std::size_t remove_many(std::span<const Entity> entities, ComponentTypeID variant_id = {}) {
+        using C = ComponentType<T>;
+        auto p = find_pool<C>(variant_id);
+        if (!p || entities.empty()) return 0;
+        Key k = key_of<C>(variant_id);
+        if (Signals *s = find_signals(k)) {
+            std::vector<Entity> present;
+            for (Entity e: entities) {
+                if (p->index_of(e) != IComponentPool::npos) present.push_back(e);
+            }
+            for (Entity e: present) s->on_destroy(e);
+            //observers can modify the registry
+            p = find_pool<C>(variant_id);
+            if (!p) return 0;
+        }
+        [[maybe_unused]] auto lk = lock_for_write<C>(p);
+        if (find_owning_group(*p)) {
+            for (Entity e: entities) detach_from_owning_group(e, *p);
+        }
+        std::size_t cnt = p->erase_many(entities);
+        if constexpr(tracks_entity_components<Traits>) {
+            for (Entity e: entities) unlink_signature(e, k);
+        }
+        return cnt;
     }
 
     ///Get a reference to a component of type T with specific component variant ID for an entity (if it exists)
     /** @tparam T Type of the component to be retrieved
      * @param e Entity whose component is to be retrieved
      * @param variant_id component variant ID to differentiate multiple components of the same type
-     * @return Ref to the component data if it exists, empty Ref otherwise
+     * @return Ref to the component data if it exists, empty Ref otherwise. For components
+     * stored as structure of arrays, the function returns std::optional with soa_ref proxy
      * @note Even if this function is const, it can return a non-const reference to the component data.
      * If you need a const reference, specify const T as the template parameter.
      */
     template<typename T>
-    constexpr Ref<T> get(Entity e, ComponentTypeID variant_id = {}) const {
-        auto iter = _storage.find(Key{Traits::template component_type_id<T>, variant_id});
-        if (iter == _storage.end()) return Ref<T>(std::nullopt);
-        auto pp = Traits::template cast_to_component_pool_ptr<T>(iter->second);
-        auto iter2 = pp->find(e);   
-        if (iter2 == pp->end()) return Traits::template create_ref<T>();
-        return Traits::template create_ref<T>(iter2->second, pp);       
+    constexpr auto get(Entity e, ComponentTypeID variant_id = {}) const {
+        auto pp = find_pool<T>(variant_id);
+        if constexpr(locks_component_pools<Traits>) {
+            //component must be found under the lock
+            auto lk = Traits::template lock_pool<T>(pp);
+            auto iter2 = safe_find(pp, e);
+            if (!pp || iter2 == pp->end()) return Traits::template create_ref<T>();
+            stamp(*pp, iter2, false);
+            return Traits::template create_ref<T>(iter2->second, pp, std::move(lk));
+        }
+        auto iter2 = safe_find(pp, e);
+        if constexpr(is_soa_ref<decltype(iter2->second)>) {
+            using R = std::optional<decltype(iter2->second)>;
+            if (!pp || iter2 == pp->end()) return R();
+            stamp(*pp, iter2, false);
+            return R(iter2->second);
+        } else {
+            if (!pp || iter2 == pp->end()) return Traits::template create_ref<T>();
+            stamp(*pp, iter2, false);
+            return Traits::template create_ref<T>(iter2->second, pp);
+        }
     }
 
     ///Get all components of type T with specific component variant ID (const version)
@@ -370,9 +809,7 @@ public:
      */
     template<typename T>
     constexpr auto all_of(ComponentTypeID variant_id = {}) const {
-        typename Traits::template ComponentPoolPtr<T> p = {};
-        auto iter = _storage.find(Key{Traits::template component_type_id<T>, variant_id});
-        if (iter != _storage.end()) p = Traits::template cast_to_component_pool_ptr<T>(iter->second);
+        auto p = find_pool<T>(variant_id);
         return std::ranges::subrange(safe_begin(p), safe_end(p));
     }
 
@@ -382,7 +819,27 @@ public:
      */
     template<typename T>
     constexpr void remove_all_of(ComponentTypeID variant_id = {}) {
-        _storage.erase(Key{Traits::template component_type_id<T>, variant_id});
+        Key k{Traits::template component_type_id<T>, variant_id};
+        auto iter = _storage.find(k);
+        if (iter == _storage.end()) return;
+        if (Signals *s = find_signals(k)) {
+            auto p = Traits::template cast_to_component_pool_ptr<const T>(iter->second);
+            std::vector<Entity> ents;
+            ents.reserve(p->size());
+            for (const auto &[e, _]: *p) ents.push_back(e);
+            for (Entity e: ents) s->on_destroy(e);
+            //observers can modify the registry
+            iter = _storage.find(k);
+            if (iter == _storage.end()) return;
+        }
+        dissolve_owning_group(*iter->second);
+        if constexpr(tracks_entity_components<Traits>) {
+            auto p = Traits::template cast_to_component_pool_ptr<T>(iter->second);
+            for (const auto &[e, _]: *p) unlink_signature(e, k);
+        }
+        unindex_pool<T>(variant_id);
+        _storage.erase(k);
+        ++_pool_epoch;
     }
 
     /// Iterate over all components of an entity and invoke a visitor function for each component (const version)
@@ -398,10 +855,21 @@ public:
      * - ComponentTypeID: component variant ID
      * - ComponentTypeID: type-component ID
      * The function is invoked for each component of the entity.
+     *
+     * If the registry shares pools with snapshots, the visitor which accepts AnyRef
+     * (non-const) causes copy of each visited pool, which is still shared. Use ConstAnyRef
+     * for read only access
      */
     template<ComponentVisitor Fn>
     auto for_each_component(Entity e, Fn &&fn) const {
-        for (const auto &[k, v]: _storage) {
+        constexpr bool read_only = std::is_invocable_v<Fn, ConstAnyRef>
+                || std::is_invocable_v<Fn, ConstAnyRef, ComponentTypeID>
+                || std::is_invocable_v<Fn, ConstAnyRef, ComponentTypeID, ComponentTypeID>;
+        auto visit = [&](const Key &k, const PPool &v) {
+            if constexpr(!read_only) {
+                if (!v->entity(e)) return;
+                detach_pool(v);
+            }
             AnyRef c = v->entity(e);
             if (c) {
                 if constexpr(std::is_invocable_v<Fn, AnyRef>) {
@@ -413,54 +881,139 @@ public:
                     fn(c,k._variant_id, k._type_id);
                 }                    
             }
+        };
+        if constexpr(tracks_entity_components<Traits>) {
+            auto iter = _signatures.find(e);
+            if (iter == _signatures.end()) return;
+            for (const Key &k: iter->second) {
+                auto p = _storage.find(k);
+                if (p != _storage.end()) visit(k, p->second);
+            }
+        } else {
+            for (const auto &[k, v]: _storage) {
+                visit(k, v);
+            }
         }
-
     }
 
     ///Create a view for iterating over entities with specific components
     /** @tparam Components Types of components to be included in the view. You can use
-     * qualifier const to indicate read-only components.
+     * qualifier const to indicate read-only components. The list can contain Exclude<...>
+     * with components which must not be present and Optional<...> with components which
+     * can be missing
      *  @param ids Optional list of component variant IDs to include in the view.
-     *  If empty, default component variant ID (0) is used for all components.
+     *  If empty, default component variant ID (0) is used for all components. The ids are
+     *  assigned to required components only, excluded and optional components use default variant
      *  @return View object for iterating over entities with the specified components
      * The view can be used in range-based for loops and other range algorithms. The view is compatible with the C++20 ranges library.
      * Each element of the view is a tuple containing the entity and references to the requested components.
+     * If Exclude or Optional is used, FilteredView is returned, optional components are
+     * appended to the end of the tuple as OptionalRef
+     *
+     * @code
+     * for (auto [e, pos, vel, mass]: r.view<Position, const Velocity, Exclude<Frozen>, Optional<const Mass> >()) {
+     *      if (mass) ...
+     * }
+     * @endcode
      */
     template<typename ... Components>
     constexpr auto view(std::span<const ComponentTypeID> ids) const {
-        std::array<ComponentTypeID, sizeof...(Components)> idsarr;
-        auto itr = ids.begin();
-        for (auto  &x: idsarr) {
-            if (itr == ids.end()) x = {};
-            else {
-                x = *itr;
-                ++itr;
-            }
+        if constexpr((is_view_filter<Components> || ...)) {
+            using Split = ViewComponents<Components...>;
+            return filtered_view(ids, static_cast<typename Split::Required *>(nullptr),
+                                      static_cast<typename Split::Excluded *>(nullptr),
+                                      static_cast<typename Split::Optionals *>(nullptr));
+        } else {
+            return View<std::tuple<PoolPtr<Components>...> >(find_pools<Components...>(ids));
         }
-        using Pools = std::tuple<typename Traits::template ComponentPoolPtr<Components> ...>;
-        Pools pools;
-
-        using ComponentTuple = std::tuple<Components ...>;
-
-        sequence_iterate<sizeof...(Components)>([&](auto idx){
-            using T = std::tuple_element_t<idx, ComponentTuple>;
-            auto f = _storage.find(Key{Traits::template component_type_id<T>, idsarr[idx]});
-            if (f == _storage.end()) {
-                std::get<idx>(pools) = nullptr;
-            } else {
-                std::get<idx>(pools) = Traits::template cast_to_component_pool_ptr<T>(f->second);
-            }
-        });
-
-        return View<Pools>(pools);
     }
 
     template<typename ... Components>
     constexpr auto view(std::initializer_list<ComponentTypeID> ids = {}) const {
         return view<Components...>(std::span<const ComponentTypeID>(ids));
     }
+
+    ///Create a query, which caches pools of a view
+    /**
+     * @tparam Components same as view()
+     * @param ids same as view()
+     * @return query object (see GenericQuery). It refers to this registry, keep it
+     * for repeated iterations (for example, as a member of a system)
+     */
+    template<typename ... Components>
+    constexpr Query<Components...> query(std::initializer_list<ComponentTypeID> ids = {}) const {
+        return Query<Components...>(*this, std::span<const ComponentTypeID>(ids));
+    }
+
+    ///Retrieve counter of changes of the list of pools
+    /**
+     * The counter is incremented when a pool is created, replaced (group_entities(),
+     * copy on write) or removed (remove_all_of()). Pointers to pools retrieved earlier
+     * are valid while the counter is the same
+     */
+    constexpr std::size_t pool_epoch() const {return _pool_epoch;}
     
 
+    ///Retrieve components as aligned contiguous arrays
+    /**
+     * @tparam Components types of components, const qualifier for read-only access
+     * @param ids optional list of component variant IDs
+     * @return ViewColumns with span of entities and span of values for every component. For a
+     * single component, whole pool is returned. For multiple components, the pools must be
+     * fully grouped (see group() and create_owning_group()), otherwise nullopt is returned
+     *
+     * The spans are invalidated by any change of the pools (adding or removing components)
+     * @note not available for components with ComponentLayout::soa, use column() of their pool
+     */
+    template<typename ... Components>
+    constexpr auto columns(std::span<const ComponentTypeID> ids) const {
+        auto d = view<Components...>(ids).dense();
+        using R = std::optional<decltype(d->columns())>;
+        if (!d) return R();
+        return R(d->columns());
+    }
+
+    template<typename ... Components>
+    constexpr auto columns(std::initializer_list<ComponentTypeID> ids = {}) const {
+        return columns<Components...>(std::span<const ComponentTypeID>(ids));
+    }
+
+    ///Lock pools of components (only when the traits lock pools, see ConcurrentRegistryTraits)
+    /**
+     * @tparam Components component types. Pools of const components are locked shared,
+     * other pools exclusively. Each pool can be listed only once
+     * @param ids variants of components (in order of types)
+     * @return tuple of locks, pools are unlocked when the tuple is destroyed. Pools which
+     * don't exist are not locked
+     *
+     * Pools are locked in a fixed order, so threads which lock overlapping sets of pools
+     * don't deadlock. Hold the locks while iterating a view of the same components.
+     */
+    template<typename ... Components>
+    requires(locks_component_pools<Traits>)
+    auto lock(std::span<const ComponentTypeID> ids) const {
+        std::array<ComponentTypeID, sizeof...(Components)> variants = {};
+        std::copy_n(ids.begin(), std::min(ids.size(), variants.size()), variants.begin());
+        return [&]<std::size_t ... Is>(std::index_sequence<Is...>) {
+            std::tuple<typename Traits::template PoolLock<Components>...> locks(
+                Traits::template lock_pool<Components>(find_pool<Components>(variants[Is]), std::defer_lock)...);
+            std::array<std::pair<const void *, std::size_t>, sizeof...(Is)> order = {
+                std::pair<const void *, std::size_t>(std::get<Is>(locks).mutex(), Is)...
+            };
+            std::sort(order.begin(), order.end());
+            for (const auto &[m, idx]: order) {
+                if (m) ((idx == Is?std::get<Is>(locks).lock():void()),...);
+            }
+            return locks;
+        }(std::index_sequence_for<Components...>());
+    }
+
+    template<typename ... Components>
+    requires(locks_component_pools<Traits>)
+    auto lock(std::initializer_list<ComponentTypeID> ids = {}) const {
+        return lock<Components...>(std::span<const ComponentTypeID>(ids));
+    }
+
     ///Check whether an entity has a component of type T with specific component variant ID
     /** @tparam Component Type of the component to be checked
      *  @param e Entity to be checked
@@ -469,7 +1022,16 @@ public:
      */
     template<typename Component>
     constexpr bool has(Entity e, ComponentTypeID subid = {}) const {
-        return get<Component>(e,subid);
+        //read-only access - no copy on write, no change stamp
+        auto pp = find_pool<const Component>(subid);
+        if (!pp) return false;
+        if constexpr(locks_component_pools<Traits>) {
+            //shared lock is enough
+            auto lk = Traits::template lock_pool<const Component>(pp);
+            return pp->find(e) != pp->end();
+        } else {
+            return pp->find(e) != pp->end();
+        }
     }
 
     ///Check whether an entity has all specified components (with optional component variant IDs)
@@ -505,10 +1067,14 @@ public:
      *  @return true if the entity has any component, false otherwise   
      */
     constexpr bool is_known(Entity e) const {
-        for (const auto &[k, p]: _storage) {
-            if (p->entity(e)) return true;
+        if constexpr(tracks_entity_components<Traits>) {
+            return _signatures.find(e) != _signatures.end();
+        } else {
+            for (const auto &[k, p]: _storage) {
+                if (p->index_of(e) != IComponentPool::npos) return true;
+            }
+            return false;
         }
-        return false;
     }
 
  
@@ -528,6 +1094,10 @@ public:
     constexpr bool group_entities(ComponentTypeID variant, Fn &&predicate) {
         auto mitr = _storage.find(Key{Traits::template component_type_id<T>, variant});
         if (mitr == _storage.end() ) return false;
+        //pool is kept packed by owning group
+        if (find_owning_group(*mitr->second)) return false;
+        //items are moved from the pool
+        detach_pool(mitr->second);
         auto ct = Traits::template cast_to_component_pool_ptr<T>(mitr->second);
 
         auto b = ct->begin();
@@ -565,8 +1135,12 @@ public:
                 new_pool->emplace(std::move(itm.first), std::move(itm.second));
             }
         });
+        new_pool->set_group(PoolGroup{0, static_cast<std::size_t>(std::distance(b, st)), sortMap.size()});
+        if constexpr(has_change_tracking<ComponentType<T> >) new_pool->copy_ticks(*ct);
         ct->clear();    //clear content before destruction to prevent to call drop()
         mitr->second = std::move(new_pool_ptr);
+        index_pool<T>(variant, mitr->second);
+        ++_pool_epoch;
         return true;
     }   
 
@@ -594,7 +1168,7 @@ public:
 
     template<typename T, typename U, typename ... Vs>
     constexpr bool group_entities(ComponentTypeID variant_t, std::initializer_list<ComponentTypeID> variant_uvs ) {
-        return optimize_pool<T, U, Vs...>(variant_t, std::span<const ComponentTypeID>(variant_uvs));
+        return group_entities<T, U, Vs...>(variant_t, std::span<const ComponentTypeID>(variant_uvs));
     }
 
     template<typename ... Components>
@@ -609,6 +1183,65 @@ public:
         return optimize_rotate<Components...>(variants);
     }
 
+    ///Create owning group
+    /**
+     * Owning group keeps entities having all specified components packed at the
+     * beginning of every pool of the group (in the same order). The packing is
+     * maintained incrementally by set(), emplace(), remove() and destroy_entity(),
+     * so a view over the components of the group is always iterated in lockstep
+     * without any lookup.
+     *
+     * @tparam Components components of the group (at least two)
+     * @param variants list of component variants (default is 0)
+     * @retval true group has been created
+     * @retval false a pool is already owned by other group, or the registry copies
+     * pools on write (owning groups are not supported)
+     *
+     * @note pools of the group cannot be grouped by group() or group_entities(). The
+     * group is dissolved, when any of its pools is removed by remove_all_of().
+     * Components must be added and removed through the registry API
+     */
+    template<typename ... Components>
+    constexpr bool create_owning_group(std::span<const ComponentTypeID> variants = {}) {
+        static_assert(sizeof...(Components) > 1);
+        //packing modifies all pools of the group, this is not supported with shared pools
+        if constexpr(copies_pools_on_write<Traits>) return false;
+        constexpr auto cnt = sizeof...(Components);
+        std::array<ComponentTypeID, cnt> tmp = {};
+        std::copy_n(variants.begin(), std::min(variants.size(), cnt), tmp.begin());
+        using ComponentTuple = std::tuple<Components...>;
+        OwningGroup grp{_group_serial+1, 0, {}};
+        bool ok = true;
+        sequence_iterate<cnt>([&](auto idx){
+            using C = std::tuple_element_t<idx, ComponentTuple>;
+            IComponentPool &p = *create_component_if_needed<C>(tmp[idx]);
+            if (find_owning_group(p)) ok = false;
+            grp.pools.push_back(&p);
+        });
+        if (!ok) return false;
+        ++_group_serial;
+        std::vector<Entity> ents;
+        for (const auto &[e, _]: *create_component_if_needed<std::tuple_element_t<0, ComponentTuple> >(tmp[0])) {
+            ents.push_back(e);
+        }
+        for (Entity e: ents) {
+            if (std::all_of(grp.pools.begin(), grp.pools.end(), [&](IComponentPool *p){
+                return p->index_of(e) != IComponentPool::npos;
+            })) {
+                for (IComponentPool *p: grp.pools) p->swap_items(p->index_of(e), grp.size);
+                ++grp.size;
+            }
+        }
+        update_owning_group(grp);
+        _owning_groups.push_back(std::move(grp));
+        return true;
+    }
+
+    template<typename ... Components>
+    constexpr bool create_owning_group(std::initializer_list<ComponentTypeID> variants) {
+        return create_owning_group<Components...>(std::span<const ComponentTypeID>(variants));
+    }
+
     ///Find an entity by its name (if it has EntityName component)
     /** @param name Name of the entity to be found
      *  @return Optional containing the entity if found, empty Optional otherwise
@@ -616,7 +1249,7 @@ public:
      * @note in case of multiple entities with the same name, the first one found is returned
      */      
     constexpr std::optional<Entity> find_by_name(const std::string_view name) const {
-        auto view = this->view<EntityName>();
+        auto view = this->view<const EntityName>();
         for (auto [e, en]: view) {
             if (static_cast<std::string_view>(en) == name) return e;
         }
@@ -630,7 +1263,7 @@ public:
      *  @return Pointer to the component pool if created or already exists, nullptr otherwise
      */
     template<typename Component>
-    PoolType<Component> *create_component_pool(ComponentTypeID variant = {}) {
+    constexpr PoolPtr<Component> create_component_pool(ComponentTypeID variant = {}) {
         return create_component_if_needed<Component>(variant);
     }
 
@@ -641,27 +1274,392 @@ public:
      *  @return Pointer to the component pool if exists, nullptr otherwise
      */
     template<typename Component>
-     PoolType<Component> *get_component_pool(ComponentTypeID variant = {}) const {
-        auto r = _storage.find(Key{Traits::template component_type_id<Component>, variant});
-        if (r == _storage.end()) return nullptr;
-        return Traits::template cast_to_component_pool_ptr<Component>(r->second);
+    constexpr PoolPtr<Component> get_component_pool(ComponentTypeID variant = {}) const {
+        return find_pool<Component>(variant);
     }
 
+    template<typename> friend class GenericCommandBuffer;
+
 protected:
+
+    ///creates key of pool of component T
+    template<typename T>
+    static constexpr Key key_of(ComponentTypeID variant_id) {
+        return Key{Traits::template component_type_id<T>, variant_id};
+    }
+
+    ///finds pools of components, missing pools are null
+    /** @param ids variant ids, missing ids are default */
+    template<typename ... Components>
+    constexpr std::tuple<PoolPtr<Components>...> find_pools(std::span<const ComponentTypeID> ids) const {
+        std::array<ComponentTypeID, sizeof...(Components)> idsarr;
+        auto itr = ids.begin();
+        for (auto  &x: idsarr) {
+            if (itr == ids.end()) x = {};
+            else {
+                x = *itr;
+                ++itr;
+            }
+        }
+        std::tuple<PoolPtr<Components>...> pools;
+
+        using ComponentTuple = std::tuple<Components ...>;
+
+        sequence_iterate<sizeof...(Components)>([&](auto idx){
+            using T = std::tuple_element_t<idx, ComponentTuple>;
+            std::get<idx>(pools) = find_pool<T>(idsarr[idx]);
+        });
+        return pools;
+    }
+
+    ///creates view with excluded and optional components
+    template<typename ... Rs, typename ... Xs, typename ... Os>
+    constexpr auto filtered_view(std::span<const ComponentTypeID> ids, std::tuple<Rs...> *,
+                                 std::tuple<Xs...> *, std::tuple<Os...> *) const {
+        static_assert(sizeof...(Rs) >= 1, "At least one required component must be specified");
+        auto base = view<Rs...>(ids);
+        using ExcludedPools = std::tuple<PoolPtr<const Xs>...>;
+        using OptionalPools = std::tuple<PoolPtr<Os>...>;
+        return FilteredView<decltype(base), ExcludedPools, OptionalPools>(std::move(base),
+                find_pools<const Xs...>({}), find_pools<Os...>({}));
+    }
+
+    ///finds pool of component T, returns null if pool doesn't exist
+    template<typename T>
+    constexpr PoolPtr<T> find_pool(ComponentTypeID variant_id) const {
+        if constexpr(indexes_pools) {
+            if (!std::is_constant_evaluated() && variant_id == ComponentTypeID{}) {
+                std::size_t idx = component_type_index<ComponentType<T> >();
+                if (idx < _pool_index.size()) {
+                    const IndexedPool &ip = _pool_index[idx];
+                    //type is checked, indexes can differ between shared libraries
+                    if (ip._pool && ip._type_id == Traits::template component_type_id<T>) {
+                        return static_cast<PoolPtr<T> >(ip._pool);
+                    }
+                }
+            }
+        }
+        auto iter = _storage.find(key_of<T>(variant_id));
+        if (iter == _storage.end()) return nullptr;
+        if (!std::is_const_v<T>) detach_pool(iter->second);
+        return Traits::template cast_to_component_pool_ptr<T>(iter->second);
+    }
+
+    ///registers pool of the default variant in the dense index
+    template<typename T>
+    constexpr void index_pool([[maybe_unused]] ComponentTypeID variant_id, [[maybe_unused]] const PPool &ptr) {
+        if constexpr(indexes_pools) {
+            if (std::is_constant_evaluated() || variant_id != ComponentTypeID{}) return;
+            std::size_t idx = component_type_index<ComponentType<T> >();
+            if (idx >= _pool_index.size()) _pool_index.resize(idx + 1);
+            _pool_index[idx] = IndexedPool{Traits::template component_type_id<T>, ptr.get()};
+        }
+    }
+
+    ///removes pool from the dense index
+    template<typename T>
+    constexpr void unindex_pool([[maybe_unused]] ComponentTypeID variant_id) {
+        if constexpr(indexes_pools) {
+            if (std::is_constant_evaluated() || variant_id != ComponentTypeID{}) return;
+            std::size_t idx = component_type_index<ComponentType<T> >();
+            if (idx < _pool_index.size()) _pool_index[idx] = IndexedPool{};
+        }
+    }
+
+    ///result of storing a component to a pool
+    enum class StoreResult {
+        ///nothing stored, arguments were not consumed
+        rejected,
+        ///existing component has been replaced
+        replaced,
+        ///new component has been created
+        created
+    };
+
+    ///adds or replaces component in already retrieved pool, emits the signal
+    /** stale handles (see is_alive()) are rejected */
+    template<typename T, typename ... Args>
+    constexpr StoreResult emplace_to_pool(PoolPtr<T> p, Entity e, ComponentTypeID variant_id, Args && ... args) {
+        if constexpr(recycles_ids) {
+            if (!is_alive(e)) return StoreResult::rejected;
+        }
+        StoreResult r = store_to_pool<T>(p, e, variant_id, std::forward<Args>(args)...);
+        if (r == StoreResult::rejected) return r;
+        if (Signals *s = find_signals(key_of<T>(variant_id))) {
+            if (r == StoreResult::created) s->on_construct(e);
+            else s->on_update(e);
+        }
+        return r;
+    }
+
+    ///adds or replaces component in already retrieved pool
+    template<typename T, typename ... Args>
+    constexpr StoreResult store_to_pool(PoolPtr<T> p, Entity e, ComponentTypeID variant_id, Args && ... args) {
+        [[maybe_unused]] auto lk = lock_for_write<T>(p);
+        auto r = p->try_emplace(e, std::forward<Args>(args)...);
+        //storage rejected the key (slot is owned by other generation of the entity)
+        if (r.first == p->end()) return StoreResult::rejected;
+        stamp(*p, r.first, r.second);
+        if (!r.second) {
+            if constexpr(is_soa_ref<decltype(r.first->second)>) {
+                //proxy to structure of arrays, assign all fields
+                r.first->second = ComponentType<T>(std::forward<Args>(args)...);
+            } else {
+                if constexpr(is_droppable<decltype(r.first->second)>) {
+                    drop(r.first->second);
+                }
+                std::destroy_at(std::addressof(r.first->second));
+                std::construct_at(std::addressof(r.first->second), std::forward<Args>(args)...);
+            }
+            return StoreResult::replaced;
+        }
+        link_signature(e, Key{Traits::template component_type_id<T>, variant_id});
+        attach_to_owning_group(e, *p);
+        return StoreResult::created;
+    }
+
+    ///stamps the component by current tick, if the pool tracks changes
+    /** @param pool pool (const pool is not stamped)
+     *  @param iter iterator to the component
+     *  @param added true if the component has been just inserted */
+    template<typename Pool, typename Iter>
+    constexpr void stamp([[maybe_unused]] Pool &pool, [[maybe_unused]] const Iter &iter, [[maybe_unused]] bool added) const {
+        if constexpr(requires {pool.stamp(std::size_t(), _tick, added);}) {
+            pool.stamp(static_cast<std::size_t>(iter - pool.begin()), _tick, added);
+        }
+    }
+
+    ///finds signals of the pool, returns null if signals are disabled or nobody asked for them
+    constexpr Signals *find_signals([[maybe_unused]] const Key &k) const {
+        if constexpr(emits_component_signals<Traits>) {
+            if (!_signals.size()) return nullptr;
+            auto iter = _signals.find(k);
+            if (iter != _signals.end()) return iter->second.get();
+        }
+        return nullptr;
+    }
+
+    ///retrieves signals of the pool, creates them if needed
+    Signals &signals_of(const Key &k) requires(emits_component_signals<Traits>) {
+        auto iter = _signals.find(k);
+        if (iter == _signals.end()) {
+            iter = _signals.try_emplace(k, std::make_shared<Signals>()).first;
+        }
+        return *iter->second;
+    }
+
+    ///makes the pool private to this registry before it is modified (copy on write)
+    /** The pointer is replaced by a copy of the pool, if the pool is shared with a snapshot.
+     * Called also from const functions which return non-const access to components */
+    constexpr void detach_pool([[maybe_unused]] const PPool &ptr) const {
+        if constexpr(copies_pools_on_write<Traits>) {
+            const IComponentPool *before = &*ptr;
+            Traits::detach_pool(const_cast<PPool &>(ptr));
+            //pool replaced by its copy
+            if (before != &*ptr) ++const_cast<GenericRegistry *>(this)->_pool_epoch;
+        }
+    }
+
+    ///erases all components of given entities
+    /**
+     * Every pool is visited once for whole batch and its components are erased by
+     * one virtual call (IComponentPool::erase_many()). Ids are not released, this
+     * is done by the caller
+     */
+    constexpr void erase_entities(std::span<const Entity> entities) {
+        if (entities.empty()) return;
+        std::vector<std::size_t> positions;
+        if constexpr(emits_component_signals<Traits>) {
+            if (_signals.size()) {
+                //collect first, observers can modify the registry
+                std::vector<std::pair<Signals *, Entity> > to_emit;
+                positions.resize(entities.size());
+                for (auto &[k, v]: _signals) {
+                    auto p = _storage.find(k);
+                    if (p == _storage.end() || !p->second->index_of_many(entities, positions)) continue;
+                    for (std::size_t i = 0; i < entities.size(); ++i) {
+                        if (positions[i] != IComponentPool::npos) to_emit.emplace_back(v.get(), entities[i]);
+                    }
+                }
+                for (auto &[s, e]: to_emit) s->on_destroy(e);
+            }
+        }
+        if constexpr(tracks_entity_components<Traits>) {
+            //signature lists exactly the pools of the entity
+            for (Entity entity: entities) {
+                auto iter = _signatures.find(entity);
+                if (iter == _signatures.end()) continue;
+                for (const Key &k: iter->second) {
+                    auto p = _storage.find(k);
+                    if (p != _storage.end()) {
+                        detach_pool(p->second);
+                        [[maybe_unused]] auto lk = lock_for_write(*p->second);
+                        detach_from_owning_group(entity, *p->second);
+                        p->second->erase(entity);
+                    }
+                }
+                _signatures.erase(iter);
+            }
+        } else {
+            if constexpr(copies_pools_on_write<Traits>) positions.resize(entities.size());
+            for (auto &[k,v]: _storage) {
+                if constexpr(copies_pools_on_write<Traits>) {
+                    //copy only pools where some entity lives
+                    if (!v->index_of_many(entities, positions)) continue;
+                    detach_pool(v);
+                }
+                [[maybe_unused]] auto lk = lock_for_write(*v);
+                if (find_owning_group(*v)) {
+                    for (Entity entity: entities) detach_from_owning_group(entity, *v);
+                }
+                v->erase_many(entities);
+            }
+        }
+    }
+
+    ///acquires exclusive lock of the pool if the traits lock pools
+    template<typename T>
+    static constexpr auto lock_for_write([[maybe_unused]] const PoolPtr<T> &p) {
+        if constexpr(locks_component_pools<Traits>) {
+            return Traits::template lock_pool<T>(p);
+        } else {
+            return std::monostate{};
+        }
+    }
+
+    ///acquires exclusive lock of the pool if the traits lock pools (pool of unknown type)
+    static constexpr auto lock_for_write([[maybe_unused]] const IComponentPool &pool) {
+        if constexpr(locks_component_pools<Traits>) {
+            return Traits::lock_pool_exclusive(pool);
+        } else {
+            return std::monostate{};
+        }
+    }
+
+    ///removes component from already retrieved pool
+    constexpr void remove_from_pool(IComponentPool &pool, Entity e, const Key &k) {
+        if (Signals *s = find_signals(k)) {
+            if (pool.index_of(e) == IComponentPool::npos) return;
+            s->on_destroy(e);
+        }
+        [[maybe_unused]] auto lk = lock_for_write(pool);
+        detach_from_owning_group(e, pool);
+        pool.erase(e);
+        unlink_signature(e, k);
+    }
+
     Storage _storage;
+    [[no_unique_address]] SignatureStorage _signatures;
+    [[no_unique_address]] EntityStorage _entities;
+    [[no_unique_address]] SignalStorage _signals;
+    [[no_unique_address]] PoolIndex _pool_index;
+    ///last id assigned to a group of pools
+    std::size_t _group_serial = 0;
+    ///change counter (see current_tick())
+    ChangeTick _tick = 1;
+    ///counter of changes of the list of pools (see pool_epoch())
+    std::size_t _pool_epoch = 0;
+
+    ///Owning group, pools are kept packed
+    struct OwningGroup {
+        ///id of the group (the same as id of PoolGroup)
+        std::size_t id;
+        ///count of entities in the group
+        std::size_t size;
+        ///owned pools
+        std::vector<IComponentPool *> pools;
+    };
+
+    std::vector<OwningGroup> _owning_groups;
+
+    ///Finds owning group which owns the pool
+    constexpr OwningGroup *find_owning_group(const IComponentPool &p) {
+        if (_owning_groups.empty()) return nullptr;
+        auto id = p.get_group().id;
+        if (!id) return nullptr;
+        for (auto &g: _owning_groups) {
+            if (g.id == id) return &g;
+        }
+        return nullptr;
+    }
+
+    ///Updates grouped range of all pools of the owning group
+    constexpr void update_owning_group(const OwningGroup &grp) {
+        for (IComponentPool *p: grp.pools) p->set_group(PoolGroup{grp.id, 0, grp.size});
+    }
+
+    ///Moves entity into packed range of owning group, if it has all its components
+    /** called after component has been added to pool
+     * @retval true entity has been moved
+     * @retval false nothing changed
+     */
+    constexpr bool attach_to_owning_group(Entity e, IComponentPool &pool) {
+        OwningGroup *grp = find_owning_group(pool);
+        if (!grp) return false;
+        for (IComponentPool *p: grp->pools) {
+            if (p->index_of(e) == IComponentPool::npos) return false;
+        }
+        for (IComponentPool *p: grp->pools) p->swap_items(p->index_of(e), grp->size);
+        ++grp->size;
+        update_owning_group(*grp);
+        return true;
+    }
+
+    ///Moves entity out of packed range of owning group
+    /** called before component is removed from the pool */
+    constexpr void detach_from_owning_group(Entity e, IComponentPool &pool) {
+        OwningGroup *grp = find_owning_group(pool);
+        if (!grp) return;
+        auto pos = pool.index_of(e);
+        if (pos >= grp->size) return;
+        --grp->size;
+        for (IComponentPool *p: grp->pools) p->swap_items(p->index_of(e), grp->size);
+        update_owning_group(*grp);
+    }
+
+    ///Dissolves owning group which owns the pool
+    constexpr void dissolve_owning_group(IComponentPool &pool) {
+        OwningGroup *grp = find_owning_group(pool);
+        if (!grp) return;
+        for (IComponentPool *p: grp->pools) p->set_group({});
+        _owning_groups.erase(_owning_groups.begin() + (grp - _owning_groups.data()));
+    }
+
+    ///Records that entity has component in pool k (if signatures are tracked)
+    constexpr void link_signature([[maybe_unused]] Entity e, [[maybe_unused]] const Key &k) {
+        if constexpr(tracks_entity_components<Traits>) {
+            _signatures[e].push_back(k);
+        }
+    }
+
+    ///Removes pool k from entity's signature (if signatures are tracked)
+    constexpr void unlink_signature([[maybe_unused]] Entity e, [[maybe_unused]] const Key &k) {
+        if constexpr(tracks_entity_components<Traits>) {
+            auto iter = _signatures.find(e);
+            if (iter == _signatures.end()) return;
+            auto &sig = iter->second;
+            auto f = std::find(sig.begin(), sig.end(), k);
+            if (f == sig.end()) return;
+            *f = sig.back();
+            sig.pop_back();
+            if (sig.empty()) _signatures.erase(iter);
+        }
+    }
 
     template<typename T>
     constexpr PoolPtr<T> create_component_if_needed(ComponentTypeID sub) {
         static_assert(!std::is_const_v<T> && !std::is_reference_v<T>,
         "Component type must be pure type without const or reference qualifiers");
 
+        if (auto p = find_pool<T>(sub)) return p;
         Key k{Traits::template component_type_id<T>, sub};
         auto iter = _storage.find(k);
         if (iter == _storage.end()) {
-            return Traits::template cast_to_component_pool_ptr<T>(_storage.try_emplace(k, Traits::template create_pool<T>()).first->second);
-        } else {
-            return Traits::template cast_to_component_pool_ptr<T>(iter->second);
+            ++_pool_epoch;
+            iter = _storage.try_emplace(k, Traits::template create_pool<T>()).first;
         }
+        index_pool<T>(sub, iter->second);
+        return Traits::template cast_to_component_pool_ptr<T>(iter->second);
 
     }
 
@@ -683,9 +1681,21 @@ protected:
     constexpr bool optimize_rotate(std::span<const ComponentTypeID> variants)  {
         static_assert(sizeof...(Components) > 0);
         constexpr auto cnt = sizeof...(Components)+1;
-        std::array<ComponentTypeID, cnt> tmp;        
-        std::copy(variants.begin(), variants.end(), tmp.begin());
-        return optimize_rotate_2<0, cnt, T, Components...>(tmp);
+        std::array<ComponentTypeID, cnt> tmp = {};
+        std::copy_n(variants.begin(), std::min(variants.size(), cnt), tmp.begin());
+        if (!optimize_rotate_2<0, cnt, T, Components...>(tmp)) return false;
+        //all pools contain the same sequence of entities in grouped range, mark them
+        ++_group_serial;
+        using ComponentTuple = std::tuple<T, Components...>;
+        sequence_iterate<cnt>([&](auto idx){
+            using C = std::tuple_element_t<idx, ComponentTuple>;
+            auto p = Traits::template cast_to_component_pool_ptr<C>(
+                            _storage.find(Key{Traits::template component_type_id<C>, tmp[idx]})->second);
+            PoolGroup g = p->get_group();
+            g.id = _group_serial;
+            p->set_group(g);
+        });
+        return true;
     }
 
 
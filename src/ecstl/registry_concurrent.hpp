@@ -0,0 +1,135 @@
+#pragma once
+#include "registry_shrptr.hpp"
+#include <shared_mutex>
+#include <mutex>
+
+namespace ecstl {
+
+///Mutex of a component pool
+class PoolMutex {
+public:
+    ///Retrieve the mutex (it can be locked through const pool)
+    std::shared_mutex &mutex() const {return _mutex;}
+protected:
+    mutable std::shared_mutex _mutex;
+};
+
+///Component pool extended by a reader/writer mutex
+template<typename Pool>
+class LockableComponentPool: public Pool, public PoolMutex {
+public:
+    using Pool::Pool;
+};
+
+///Reference to a component which holds lock of its pool
+/**
+ * Reference to a const component holds shared lock, reference to a non-const
+ * component holds exclusive lock. The lock is released when the reference is destroyed.
+ * The reference also keeps the pool alive.
+ *
+ * @note don't request other reference to the same pool while this reference is held
+ * by the same thread, the mutex is not recursive
+ */
+template<typename T>
+class LockedRef: public OptionalRef<T> {
+public:
+
+    using Lock = std::conditional_t<std::is_const_v<T>,
+            std::shared_lock<std::shared_mutex>, std::unique_lock<std::shared_mutex> >;
+
+    LockedRef() = default;
+    LockedRef(std::nullopt_t):OptionalRef<T>(std::nullopt) {}
+    LockedRef(T &val, std::shared_ptr<const IComponentPool> pool, Lock lock)
+        :OptionalRef<T>(val), _pool(std::move(pool)), _lock(std::move(lock)) {}
+
+    ///Returns true if the reference holds the lock
+    bool owns_lock() const {return _lock.owns_lock();}
+
+protected:
+    std::shared_ptr<const IComponentPool> _pool;
+    Lock _lock;
+};
+
+///Registry traits for multithreaded access
+/**
+ * Each component pool has own std::shared_mutex. Ref<T> returned by get() holds
+ * the lock of the pool (shared for const T, exclusive otherwise). set(), emplace(),
+ * remove() and destroy_entity() lock affected pools exclusively. So threads which
+ * work with different component types run in parallel, readers of the same type
+ * share the pool.
+ *
+ * Rules:
+ * - create pools of all components (create_component_pool()) before the threads start,
+ *   the list of pools itself is not protected. Don't use group(), owning groups and
+ *   remove_all_of() while other threads access the registry
+ * - views are not locked, lock their pools by GenericRegistry::lock() while iterating
+ * - components are always stored as array of structures (ComponentLayout is ignored)
+ */
+struct ConcurrentRegistryTraits : RegistryTraitsForSharedPtrs {
+
+    static constexpr bool lock_component_pools = true;
+
+    template<typename T>
+    using ComponentPool = LockableComponentPool<GenericComponentPool<ComponentNormalized<T>, PoolStorage> >;
+
+    template<typename T>
+    using ComponentPoolPtr =  std::conditional_t<std::is_const_v<T>,
+        std::shared_ptr<const ComponentPool<T> > , std::shared_ptr<ComponentPool<T> > >;
+
+    template<typename T>
+    static ComponentPoolPtr<T> cast_to_component_pool_ptr(const PoolSmartPtr &ptr) {
+        return std::static_pointer_cast<typename ComponentPoolPtr<T>::element_type >(ptr);
+    }
+    template<typename T>
+    static PoolSmartPtr create_pool() {
+        return std::make_shared<ComponentPool<T> >();
+    }
+
+    template<typename T>
+    using Ref = LockedRef<T>;
+
+    ///Lock of pool of T (shared for const T, exclusive otherwise)
+    template<typename T>
+    using PoolLock = typename LockedRef<T>::Lock;
+
+    ///Locks pool of T
+    /**
+     * @param ptr pointer to pool, can be null (returns empty lock)
+     * @param args extra arguments of lock (for example std::defer_lock)
+     */
+    template<typename T, typename ... Args>
+    static PoolLock<T> lock_pool(const ComponentPoolPtr<T> &ptr, Args && ... args) {
+        if (!ptr) return PoolLock<T>();
+        return PoolLock<T>(ptr->mutex(), std::forward<Args>(args)...);
+    }
+
+    ///Locks pool of unknown type exclusively
+    static std::unique_lock<std::shared_mutex> lock_pool_exclusive(const IComponentPool &pool) {
+        return std::unique_lock<std::shared_mutex>(dynamic_cast<const PoolMutex &>(pool).mutex());
+    }
+
+    ///Creates ref and locks the pool
+    /** The data should be found under the lock, the registry uses the overload with the lock */
+    template<typename T>
+    static Ref<T> create_ref(T &data, const ComponentPoolPtr<T> &ptr) {
+        return create_ref<T>(data, ptr, lock_pool<T>(ptr));
+    }
+
+    ///Creates ref which holds already acquired lock
+    template<typename T>
+    static Ref<T> create_ref(T &data, const ComponentPoolPtr<T> &ptr, PoolLock<T> lock) {
+        return Ref<T>(data, ptr, std::move(lock));
+    }
+
+    template<typename T>
+    static Ref<T> create_ref() {
+        return Ref<T>(std::nullopt);
+    }
+};
+
+static_assert(RegistryTraits<ConcurrentRegistryTraits>);
+
+///Implements registry for multithreaded access with reader/writer lock per component pool
+using RegistryConcurrent = GenericRegistry<ConcurrentRegistryTraits>;
+
+}
@@ -1,4 +1,6 @@
+#pragma once
 #include "registry.hpp"
+#include <atomic>
 
 namespace ecstl {
 
@@ -25,9 +27,105 @@ struct RegistryTraitsForSharedPtrs : DefaultRegistryTraits{
 /**
  * - views are retained even if registry is destroyed
  * - group() doesn't affect current view.
- * - this is core class which allows to implement MT safe registry with RW locks
+ * - this is core class of MT safe registry with RW locks (see registry_concurrent.hpp)
  */
 using RegistrySharedPtr = GenericRegistry<RegistryTraitsForSharedPtrs>;
 
 
-}
\ No newline at end of file
+///Pointer to a component pool which can be shared with snapshots
+/**
+ * Holds shared pointer to the pool and a flag, whether the pool is shared with
+ * a snapshot. Such pool is copied by detach() before it is modified.
+ */
+class CowPoolPtr {
+public:
+
+    using element_type = IComponentPool;
+    using CopyFn = std::shared_ptr<IComponentPool> (*)(const IComponentPool &);
+
+    CowPoolPtr() = default;
+    CowPoolPtr(std::nullptr_t) {}
+    CowPoolPtr(std::shared_ptr<IComponentPool> ptr, CopyFn copy):_ptr(std::move(ptr)), _copy(copy) {}
+
+    IComponentPool *operator->() const {return _ptr.get();}
+    IComponentPool &operator*() const {return *_ptr;}
+    IComponentPool *get() const {return _ptr.get();}
+    explicit operator bool() const {return static_cast<bool>(_ptr);}
+
+    ///Retrieve shared pointer to the pool
+    const std::shared_ptr<IComponentPool> &shared() const {return _ptr;}
+
+    ///Mark the pool as shared (called by snapshot)
+    void share() {_shared = true;}
+
+    ///Make the pool private before it is modified
+    /** The pool is copied only if it is marked as shared and other owner still exists */
+    void detach() {
+        if (!_shared) return;
+        if (_ptr.use_count() > 1) {
+            _ptr = _copy(*_ptr);
+        } else {
+            //other owners are gone, synchronize with their last access
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        _shared = false;
+    }
+
+protected:
+    std::shared_ptr<IComponentPool> _ptr;
+    CopyFn _copy = nullptr;
+    bool _shared = false;
+};
+
+///Registry traits which supports snapshots with copy on write pools
+/**
+ * GenericRegistry::snapshot() returns read-only copy of the registry which shares all
+ * pools. The pools are copied only when they are modified afterwards (by any of the
+ * registries). A render thread can iterate the snapshot without locks, while the
+ * simulation thread modifies the registry.
+ *
+ * - components must be copyable. Droppable components must implement clone(), which
+ *   returns independent copy (copy constructor of droppable components is shallow)
+ * - owning groups are not supported
+ */
+struct CopyOnWriteRegistryTraits : RegistryTraitsForSharedPtrs {
+
+    static constexpr bool copy_on_write_pools = true;
+
+    using PoolSmartPtr = CowPoolPtr;
+
+    template<typename T>
+    static ComponentPoolPtr<T> cast_to_component_pool_ptr(const PoolSmartPtr &ptr) {
+        return std::static_pointer_cast<typename ComponentPoolPtr<T>::element_type >(ptr.shared());
+    }
+    template<typename T>
+    static PoolSmartPtr create_pool() {
+        return CowPoolPtr(std::make_shared<ComponentPool<T> >(), &copy_pool<T>);
+    }
+
+    static void share_pool(PoolSmartPtr &ptr) {ptr.share();}
+    static void detach_pool(PoolSmartPtr &ptr) {ptr.detach();}
+
+    ///creates copy of pool of T
+    template<typename T>
+    static std::shared_ptr<IComponentPool> copy_pool(const IComponentPool &pool) {
+        using Pool = ComponentPool<T>;
+        using C = ComponentNormalized<T>;
+        auto r = std::make_shared<Pool>(static_cast<const Pool &>(pool));
+        if constexpr(is_droppable<C>) {
+            static_assert(requires(const C &c) {{c.clone()} -> std::same_as<C>;},
+                "Droppable component must implement clone() to be used with CopyOnWriteRegistryTraits");
+            //shallow copies are replaced without drop
+            for (auto &&[k, v]: *r) v = v.clone();
+        }
+        return r;
+    }
+};
+
+static_assert(RegistryTraits<CopyOnWriteRegistryTraits>);
+
+///Implements registry which supports snapshots (see CopyOnWriteRegistryTraits)
+using RegistryCopyOnWrite = GenericRegistry<CopyOnWriteRegistryTraits>;
+
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "registry.hpp"
+#include "utils/sparse_set_flat_map.hpp"
+
+namespace ecstl {
+
+
+///Converts key to index of the sparse array
+/** Entities are indexed by Entity::index(), so recycled ids (which differ only
+ * by generation) reuse the same slot */
+template<typename K>
+struct SparseIndexOfKey {
+    constexpr std::size_t operator()(const K &key) const {
+        if constexpr(std::is_same_v<K, Entity>) {
+            return static_cast<std::size_t>(key.index());
+        } else {
+            return get_hash(key);
+        }
+    }
+};
+
+///Registry traits which stores components in sparse sets
+/**
+ * Component pools are indexed by entity id directly (paged sparse array),
+ * so finding a component doesn't need hashing nor probing.
+ */
+struct SparseSetRegistryTraits : DefaultRegistryTraits{
+
+    template<typename K, typename V>
+    class PoolStorage: public SparseSetFlatMap<K, V, SparseIndexOfKey<K>, std::equal_to<K> > {};
+
+    template<typename T>
+    using ComponentPool = GenericComponentPool<ComponentNormalized<T>, PoolStorage>;
+
+    template<typename T>
+    using ComponentPoolPtr =  std::conditional_t<std::is_const_v<T>, const ComponentPool<T> *, ComponentPool<T> *>;
+
+    template<typename T>
+    static constexpr auto cast_to_component_pool_ptr(const PoolSmartPtr &ptr) {
+        return static_cast<ComponentPoolPtr<T> >(ptr.get());
+    }
+
+    template<typename T>
+    static constexpr PoolSmartPtr create_pool() {
+        return make_unique<ComponentPool<T> >();
+    }
+};
+
+static_assert(RegistryTraits<SparseSetRegistryTraits>);
+
+///Implements registry with sparse set component pools
+/**
+ * - fast lookup of components by entity
+ * - memory of each pool grows with highest entity index stored in it. Use
+ *   with entities created by Entity::create() (dense ids) or with recycled
+ *   ids (derive traits with recycle_entity_ids = true)
+ */
+using RegistrySparseSet = GenericRegistry<SparseSetRegistryTraits>;
+
+
+}
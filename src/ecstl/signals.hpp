@@ -122,7 +122,7 @@ namespace ecstl {
         struct ObserverReg {
             int priority;
             ConnectionMode mode;
-            std::weak_ptr<Observer> Observer;
+            std::weak_ptr<SignalObserver<void(Args...)> > Observer;
         };
 
 
@@ -319,7 +319,7 @@ namespace ecstl {
     template<typename Dispatcher, typename Lock, typename ... Args>
     class SharedSignalSlot<void(Args...), Dispatcher, Lock> {
     public:        
-        using SignalSlot = SignalSlot<void(Args...), Dispatcher, Lock>;
+        using SignalSlot = ecstl::SignalSlot<void(Args...), Dispatcher, Lock>;
         using Ref = std::shared_ptr<SignalSlot>;
         using Observer = typename SignalSlot::Observer;
         using Connection = typename SignalSlot::Connection;
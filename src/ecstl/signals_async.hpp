@@ -23,6 +23,8 @@ namespace ecstl {
 
         using Task = SignalObserver<void()>;
         using PTask = std::unique_ptr<Task>;
+        ///count of threads of the thread pool
+        static constexpr unsigned int thread_count = _n_threads;
 
         ///dispatch a task
         /**
@@ -37,7 +39,8 @@ namespace ecstl {
         requires(std::is_nothrow_invocable_v<Fn>)
         void dispatch(Fn &&fn) {
             std::lock_guard _(_core->_mx);
-            if (_core->_queue.empty()) _core->_cv.notify_one();
+            //always wake a thread, tasks dispatched in a burst must not wait for a single worker
+            _core->_cv.notify_one();
             _core->_queue.push(std::make_unique<FunctorSignalObserver<Fn, void()> >(std::forward<Fn>(fn)));            
         }
 
@@ -136,6 +139,8 @@ namespace ecstl {
 
         using Task = SignalObserver<void()>;
         using PTask = std::unique_ptr<Task>;
+        ///no threads, tasks are executed by pump_one() or pump_all()
+        static constexpr unsigned int thread_count = 0;
 
         ///dispatch a task
         /**
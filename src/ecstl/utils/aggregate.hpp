@@ -0,0 +1,113 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ecstl {
+
+namespace _details {
+
+    ///converts to anything, used to count fields of an aggregate
+    struct any_field {
+        template<typename T>
+        constexpr operator T() const;
+    };
+
+    template<typename T, typename ... Args>
+    constexpr std::size_t aggregate_arity_impl() {
+        if constexpr(requires {T{std::declval<Args>()..., any_field{}};}) {
+            return aggregate_arity_impl<T, Args..., any_field>();
+        } else {
+            return sizeof...(Args);
+        }
+    }
+
+}
+
+///Maximum count of fields supported by aggregate_tie()
+static constexpr std::size_t max_aggregate_fields = 12;
+
+///Count of fields of an aggregate
+/**
+ * Counts the fields by brace initialization. Fields must not be arrays or
+ * aggregates initialized by brace elision, otherwise the count is wrong
+ */
+template<typename T>
+requires(std::is_aggregate_v<T>)
+constexpr std::size_t aggregate_arity = _details::aggregate_arity_impl<T>();
+
+///Returns tuple of references to all fields of an aggregate
+/**
+ * @param v aggregate object
+ * @return std::tuple of references (const references for const object)
+ */
+template<typename T>
+requires(std::is_aggregate_v<std::remove_cv_t<T>>)
+constexpr auto aggregate_tie(T &v) {
+    constexpr std::size_t n = aggregate_arity<std::remove_cv_t<T> >;
+    static_assert(n <= max_aggregate_fields, "Too many fields in aggregate");
+    if constexpr(n == 0) {
+        return std::tuple<>();
+    } else if constexpr(n == 1) {
+        auto &[a] = v;
+        return std::tie(a);
+    } else if constexpr(n == 2) {
+        auto &[a,b] = v;
+        return std::tie(a,b);
+    } else if constexpr(n == 3) {
+        auto &[a,b,c] = v;
+        return std::tie(a,b,c);
+    } else if constexpr(n == 4) {
+        auto &[a,b,c,d] = v;
+        return std::tie(a,b,c,d);
+    } else if constexpr(n == 5) {
+        auto &[a,b,c,d,e] = v;
+        return std::tie(a,b,c,d,e);
+    } else if constexpr(n == 6) {
+        auto &[a,b,c,d,e,f] = v;
+        return std::tie(a,b,c,d,e,f);
+    } else if constexpr(n == 7) {
+        auto &[a,b,c,d,e,f,g] = v;
+        return std::tie(a,b,c,d,e,f,g);
+    } else if constexpr(n == 8) {
+        auto &[a,b,c,d,e,f,g,h] = v;
+        return std::tie(a,b,c,d,e,f,g,h);
+    } else if constexpr(n == 9) {
+        auto &[a,b,c,d,e,f,g,h,i] = v;
+        return std::tie(a,b,c,d,e,f,g,h,i);
+    } else if constexpr(n == 10) {
+        auto &[a,b,c,d,e,f,g,h,i,j] = v;
+        return std::tie(a,b,c,d,e,f,g,h,i,j);
+    } else if constexpr(n == 11) {
+        auto &[a,b,c,d,e,f,g,h,i,j,k] = v;
+        return std::tie(a,b,c,d,e,f,g,h,i,j,k);
+    } else {
+        auto &[a,b,c,d,e,f,g,h,i,j,k,l] = v;
+        return std::tie(a,b,c,d,e,f,g,h,i,j,k,l);
+    }
+}
+
+template<typename V, bool is_const>
+class soa_ref;
+
+///Checks whether T is soa_ref proxy (see soa_flat_map.hpp)
+template<typename T>
+constexpr bool is_soa_ref = false;
+template<typename V, bool is_const>
+constexpr bool is_soa_ref<soa_ref<V, is_const> > = true;
+
+namespace _details {
+    template<typename Tuple>
+    struct decay_tuple;
+    template<typename ... Ts>
+    struct decay_tuple<std::tuple<Ts...> > {
+        using type = std::tuple<std::remove_cvref_t<Ts>...>;
+    };
+}
+
+///Tuple of types of fields of an aggregate
+template<typename T>
+using aggregate_fields_t = typename _details::decay_tuple<decltype(aggregate_tie(std::declval<T &>()))>::type;
+
+}
@@ -106,7 +106,7 @@ public:
     ///Get OptionalRef to type T (empty if type does not match)
    template<typename T>
     OptionalRef<const T> get_if() const {
-        if (holds_alternative<T>(*this)) return OptionalRef<const T>(get<T>(*this));
+        if (holds_alternative<T>(*this)) return OptionalRef<const T>(get<const T>(*this));
         else return OptionalRef<const T>();
     }
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <utility>
+#include "sequence.hpp"
+
+namespace ecstl {
+
+///Value of a change counter (see GenericRegistry::current_tick())
+using ChangeTick = std::uint32_t;
+
+///Ticks stored for an item of ChangeTrackedMap
+struct ChangeTicks {
+    ///tick when the item was inserted
+    ChangeTick added = 0;
+    ///tick when the item was changed last time (includes insertion)
+    ChangeTick changed = 0;
+};
+
+///Flat map extended by a tick stamp for each item
+/**
+ * Stamps are stored in an array aligned with dense positions of the map. The map
+ * keeps the array aligned on insertion, erase and swap_items(), but it doesn't
+ * stamp anything itself, the owner calls stamp() with its own counter.
+ *
+ * @tparam Map flat map with dense storage (IndexedFlatMap, SparseSetFlatMap, SoaFlatMap).
+ * Erase must move the last item into the erased position.
+ */
+template<typename Map>
+class ChangeTrackedMap: public Map {
+public:
+
+    using Map::Map;
+
+    template<typename Key, typename ... Args>
+    requires requires(Map &m, Key &&k, Args && ... args) {m.try_emplace(std::forward<Key>(k), std::forward<Args>(args)...);}
+    constexpr auto try_emplace(Key &&key, Args && ... args) {
+        auto r = Map::try_emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+        if (r.second) _ticks.emplace_back();
+        return r;
+    }
+
+    template<typename Key, typename ... Args>
+    requires requires(Map &m, Key &&k, Args && ... args) {m.try_emplace(std::forward<Key>(k), std::forward<Args>(args)...);}
+    constexpr auto emplace(Key &&key, Args && ... args) {
+        return try_emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+    }
+
+    template<typename Pair>
+    requires requires(Map &m, Pair &&p) {m.insert(std::forward<Pair>(p));}
+    constexpr auto insert(Pair &&p) {
+        auto r = Map::insert(std::forward<Pair>(p));
+        if (r.second) _ticks.emplace_back();
+        return r;
+    }
+
+    template<typename Key>
+    requires requires(Map &m, const Key &k) {m.erase(k);}
+    constexpr bool erase(const Key &key) {
+        auto iter = Map::find(key);
+        if (iter == Map::end()) return false;
+        std::size_t pos = iter - Map::begin();
+        Map::erase(key);
+        _ticks[pos] = _ticks.back();
+        _ticks.pop_back();
+        return true;
+    }
+
+    constexpr auto erase(typename Map::iterator it) {
+        erase(it->first);
+        return it;
+    }
+
+    ///Erases items at given positions at once (positions sorted and unique)
+    constexpr void erase_at(std::span<const std::size_t> positions) {
+        auto new_size = fill_holes_from_back(positions, _ticks.size(), [&](std::size_t from, std::size_t to){
+            _ticks[to] = _ticks[from];
+        });
+        _ticks.resize(new_size);
+        Map::erase_at(positions);
+    }
+
+    constexpr void clear() {
+        Map::clear();
+        _ticks.clear();
+    }
+
+    constexpr void reserve(std::size_t sz) {
+        Map::reserve(sz);
+        _ticks.reserve(sz);
+    }
+
+    constexpr void swap_items(std::size_t a, std::size_t b) {
+        Map::swap_items(a, b);
+        std::swap(_ticks[a], _ticks[b]);
+    }
+
+    ///Stamp item at given position
+    /**
+     * @param pos position of the item
+     * @param tick value of the counter
+     * @param added true if the item has been inserted (sets both ticks)
+     */
+    constexpr void stamp(std::size_t pos, ChangeTick tick, bool added) {
+        if (added) _ticks[pos].added = tick;
+        _ticks[pos].changed = tick;
+    }
+
+    ///Retrieve ticks of all items, in the same order as the items
+    constexpr std::span<const ChangeTicks> ticks() const {
+        return _ticks;
+    }
+
+    ///Copy ticks of items from other map (matched by key)
+    /** Used when items are moved to a new map in different order */
+    constexpr void copy_ticks(const ChangeTrackedMap &other) {
+        std::size_t pos = 0;
+        for (const auto &itm: *this) {
+            auto iter = other.find(itm.first);
+            if (iter != other.end()) _ticks[pos] = other._ticks[iter - other.begin()];
+            ++pos;
+        }
+    }
+
+protected:
+    std::vector<ChangeTicks> _ticks;
+};
+
+}
@@ -2,11 +2,22 @@
 
 #include "paired_iterator.hpp"
 #include "open_hash_map.hpp"
+#include "sequence.hpp"
 #include <vector>
+#include <span>
 
 namespace ecstl {
 
-template<typename K, typename V, typename Hasher = std::hash<K>, typename Equal = std::equal_to<K> >
+///Flat map with dense keys and values, indexed by OpenHashMap
+/**
+ * @tparam K key type
+ * @tparam V value type
+ * @tparam Hasher hash function
+ * @tparam Equal equality of keys
+ * @tparam probing probing strategy of the index
+ */
+template<typename K, typename V, typename Hasher = std::hash<K>, typename Equal = std::equal_to<K>,
+         OpenHashProbing probing = OpenHashProbing::linear>
 class IndexedFlatMap {
 public:
 
@@ -79,6 +90,23 @@ public:
         return true;
     }
 
+    ///Erases items at given positions at once
+    /**
+     * @param positions positions of items, sorted and unique
+     *
+     * Holes are filled by items from the end, the index is updated only for moved items
+     */
+    constexpr void erase_at(std::span<const std::size_t> positions) {
+        for (std::size_t pos: positions) _index.erase(_keys[pos]);
+        auto new_size = fill_holes_from_back(positions, _keys.size(), [&](std::size_t from, std::size_t to){
+            _keys[to] = std::move(_keys[from]);
+            _values[to] = std::move(_values[from]);
+            _index.find(_keys[to])->second = to;
+        });
+        _keys.erase(_keys.begin() + new_size, _keys.end());
+        _values.erase(_values.begin() + new_size, _values.end());
+    }
+
     constexpr iterator erase(iterator it) {
         erase(it->first);
         return it;
@@ -93,9 +121,12 @@ public:
     }
 
     constexpr std::size_t size() const {return _keys.size();}
+    ///count of items which can be stored without reallocation
+    constexpr std::size_t capacity() const {return _keys.capacity();}
 
     constexpr void reserve(std::size_t sz) {
         _keys.reserve(sz);
+        _index.reserve(sz);
         _values.reserve(sz);
 
     }
@@ -106,8 +137,24 @@ public:
         _index.clear();
     }
 
+    ///Swaps two items at given positions (index is updated)
+    constexpr void swap_items(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        std::swap(_keys[a], _keys[b]);
+        std::swap(_values[a], _values[b]);
+        _index.find(_keys[a])->second = a;
+        _index.find(_keys[b])->second = b;
+    }
+
+    ///Retrieve all keys as contiguous array
+    constexpr std::span<const K> keys() const {return _keys;}
+    ///Retrieve all values as contiguous array, items are in the same order as keys
+    constexpr std::span<V> values() {return _values;}
+    ///Retrieve all values as contiguous array, items are in the same order as keys
+    constexpr std::span<const V> values() const {return _values;}
+
 protected:
-    OpenHashMap<K, std::size_t, Hasher, Equal> _index;
+    OpenHashMap<K, std::size_t, Hasher, Equal, probing> _index;
     std::vector<K> _keys;
     std::vector<V> _values;
 
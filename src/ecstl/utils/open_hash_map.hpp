@@ -1,5 +1,15 @@
 #pragma once
+#include <algorithm>
 #include <functional>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ECSTL_OPEN_HASH_MAP_SSE2 1
+#endif
 
 namespace ecstl {
 
@@ -45,7 +55,69 @@ namespace ecstl {
     };
 
 
-    template<typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K> >
+    ///Probing strategy of the OpenHashMap
+    enum class OpenHashProbing {
+        ///Linear probing over prime sized table, occupancy is stored in a bitmap (lowest memory)
+        linear,
+        ///Linear probing over power of two sized table. Every slot has control byte with 7-bit
+        ///fingerprint of the hash. Probing compares 16 control bytes at once (SSE2 if available)
+        swiss,
+        ///Robin Hood probing over power of two sized table. Every slot stores its distance from the
+        ///home slot and 8-bit fragment of the hash (2 bytes per slot, swiss needs 1 byte per slot
+        ///and 16 more bytes). Lookup of a missing key stops at the first item
+        ///closer to its home slot, so the table can be loaded up to 7/8
+        robin_hood
+    };
+
+    ///Helpers for swiss probing - operations with group of control bytes
+    namespace ctrl_group {
+
+        ///count of control bytes processed at once
+        static constexpr std::size_t width = 16;
+        ///control byte of an empty slot. Occupied slot contains 7-bit fingerprint
+        static constexpr std::uint8_t empty = 0x80;
+
+        ///Result of group scan, bit N is set for the control byte N in the group
+        struct Mask {
+            std::uint32_t match;
+            std::uint32_t empty;
+        };
+
+        ///Scans group of control bytes
+        /**
+         * @param ctrl pointer to first control byte, there must be at least width bytes available
+         * @param h2 fingerprint to match
+         * @return masks of matching and empty slots
+         */
+        constexpr Mask scan(const std::uint8_t *ctrl, std::uint8_t h2) {
+#ifdef ECSTL_OPEN_HASH_MAP_SSE2
+            if (!std::is_constant_evaluated()) {
+                __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+                return {
+                    static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(h2))))),
+                    static_cast<std::uint32_t>(_mm_movemask_epi8(g))
+                };
+            }
+#endif
+            Mask r = {0,0};
+            for (std::size_t i = 0; i < width; ++i) {
+                r.match |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+                r.empty |= static_cast<std::uint32_t>(ctrl[i] == empty) << i;
+            }
+            return r;
+        }
+    }
+
+    ///Open addressing hash map
+    /**
+     * @tparam K key
+     * @tparam V value
+     * @tparam Hash hash function
+     * @tparam Equal compare function
+     * @tparam probing probing strategy, see OpenHashProbing
+     */
+    template<typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>,
+             OpenHashProbing probing = OpenHashProbing::linear>
     class OpenHashMap {
     
        
@@ -69,8 +141,8 @@ namespace ecstl {
         constexpr OpenHashMap(std::size_t size, Hash hasher = {}, Equal equal = {})
             :_hasher(std::move(hasher))
             ,_eq(std::move(equal))
-            ,_items(size)
-            ,_stateb(initStateArray(size))
+            ,_items(normalize_capacity(size))
+            ,_stateb(initStateArray(normalize_capacity(size)))
             ,_size(0)
             {
             }
@@ -141,9 +213,7 @@ namespace ecstl {
                 return _owner == other._owner && _offset == other._offset;
             }
             constexpr iterator_base & operator++() {
-                do {
-                    ++_offset;
-                } while (!_owner->is_occupied(_offset));
+                _offset = _owner->next_occupied(_offset+1);
                 return *this;
             }   
 
@@ -182,27 +252,45 @@ namespace ecstl {
 
         template<typename Key, typename ... Args>
         constexpr auto try_emplace(Key &&key, Args && ... args) {
-            if ((_items.size()*3/5) <= size()) {
+            if (max_load() <= size()) {
                 expand();
             }
-            auto idx = map_key(key);            
-            auto start = idx;            
-            do {
-                if (is_occupied(idx)) {
-                    if (_eq(_items[idx].key_value.first, key)) {
-                        return std::pair(iterator(this, idx), false);
+            if constexpr(probing == OpenHashProbing::swiss) {
+                auto hash = hash_key(key);
+                auto idx = find_index(key, hash);
+                if (idx != std::size_t(-1)) return std::pair(iterator(this, idx), false);
+                idx = find_free(hash);
+                std::construct_at(&_items[idx].key_value, std::move(key), V(std::forward<Args>(args)...));
+                set_occupied(idx, hash);
+                ++_size;
+                return std::pair(iterator(this, idx), true);
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                auto hash = hash_key(key);
+                auto idx = find_index(key, hash);
+                if (idx != std::size_t(-1)) return std::pair(iterator(this, idx), false);
+                idx = make_room(hash);
+                std::construct_at(&_items[idx].key_value, std::move(key), V(std::forward<Args>(args)...));
+                ++_size;
+                return std::pair(iterator(this, idx), true);
+            } else {
+                auto idx = map_key(key);            
+                auto start = idx;            
+                do {
+                    if (is_occupied(idx)) {
+                        if (_eq(_items[idx].key_value.first, key)) {
+                            return std::pair(iterator(this, idx), false);
+                        }
+                    } else {
+                        std::construct_at(&_items[idx].key_value, std::move(key), V(std::forward<Args>(args)...));
+                        set_occupied(idx);
+                        ++_size;
+                        return std::pair(iterator(this, idx), true);
                     }
-                } else {
-                    std::construct_at(&_items[idx].key_value, std::move(key), V(std::forward<Args>(args)...));
-                    set_occupied(idx);
-                    ++_size;
-                    return std::pair(iterator(this, idx), true);
-                }
-                idx = (idx+1) % _items.size();
-            } while (idx != start);
-            //unreachable code
-            return std::pair(end(), false);
-
+                    idx = (idx+1) % _items.size();
+                } while (idx != start);
+                //unreachable code
+                return std::pair(end(), false);
+            }
         }
 
         template<typename Key, typename... Args>
@@ -211,9 +299,7 @@ namespace ecstl {
         }
 
         constexpr iterator begin() {
-            std::size_t idx = 0;
-            while (idx < _items.size() && !is_occupied(idx)) ++idx;
-            return iterator(this, idx);
+            return iterator(this, _items.size()?next_occupied(0):0);
         }
 
         constexpr iterator end() {
@@ -221,9 +307,7 @@ namespace ecstl {
         }
 
         constexpr const_iterator begin() const {
-            std::size_t idx = 0;
-            while (idx < _items.size() && !is_occupied(idx)) ++idx;
-            return const_iterator(this, idx);
+            return const_iterator(this, _items.size()?next_occupied(0):0);
         }
 
         constexpr const_iterator end() const {
@@ -238,6 +322,13 @@ namespace ecstl {
             return _items.size();
         }
 
+        ///Prepares the table for given count of items, so inserting them doesn't expand the table
+        constexpr void reserve(std::size_t count) {
+            std::size_t cap = _items.size();
+            while (load_limit(cap) < count) cap = next_capacity(cap);
+            if (cap != _items.size()) rehash(cap);
+        }
+
         constexpr iterator find(const K &key) {
             auto idx = find_index(key);
             if (idx == std::size_t(-1)) return end();
@@ -254,7 +345,9 @@ namespace ecstl {
         constexpr iterator_base<is_const> erase(iterator_base<is_const> it) {
             auto idx = it._offset;
             erase_index(idx);
-            return ++it;
+            //the slot can be filled by shifted item
+            it._offset = next_occupied(idx);
+            return it;
         }
 
         constexpr void erase(const K &key) {
@@ -301,13 +394,43 @@ namespace ecstl {
         };
 
         static constexpr size_t next_capacity(size_t current) {
-            for (size_t p : prime_sizes)
-                if (p > current) return p;
-            return current * 2 + 1; 
+            if constexpr(probing == OpenHashProbing::swiss) {
+                return current?current*2:ctrl_group::width;
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                return current?current*2:8;
+            } else {
+                for (size_t p : prime_sizes)
+                    if (p > current) return p;
+                return current * 2 + 1; 
+            }
         }
 
+        ///converts requested capacity to capacity valid for the probing
+        static constexpr size_t normalize_capacity(size_t sz) {
+            if constexpr(probing == OpenHashProbing::swiss) {
+                return sz?std::max(ctrl_group::width, std::bit_ceil(sz)):0;
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                return sz?std::bit_ceil(sz):0;
+            } else {
+                return sz;
+            }
+        }
 
-        constexpr std::size_t map_key(const K &k) const {
+        ///count of items which triggers expansion of table with given capacity
+        static constexpr std::size_t load_limit(std::size_t capacity) {
+            if constexpr(probing != OpenHashProbing::linear) {
+                return capacity*7/8;
+            } else {
+                return capacity*3/5;
+            }
+        }
+
+        ///count of items which triggers expansion
+        constexpr std::size_t max_load() const {
+            return load_limit(_items.size());
+        }
+
+        constexpr std::size_t hash_key(const K &k) const {
             std::size_t hash = _hasher(k);
             if constexpr(sizeof(std::size_t) == 4) {
                 constexpr uint32_t multiplier = 2654435761U;
@@ -318,11 +441,34 @@ namespace ecstl {
                 hash ^= (hash >> 7) ^ (hash << 11);
                 hash *= multiplier;
             }
-            return hash % _items.size();
+            return hash;
+        }
+
+        ///maps hash to home slot
+        constexpr std::size_t hash_to_index(std::size_t hash) const {
+            if constexpr(probing != OpenHashProbing::linear) {
+                //capacity is power of two, use highest bits of the hash
+                return hash >> (sizeof(std::size_t)*8 - std::countr_zero(_items.size()));
+            } else {
+                return hash % _items.size();
+            }
+        }
+
+        ///extracts 7-bit fingerprint stored in control byte (swiss probing)
+        static constexpr std::uint8_t hash_to_h2(std::size_t hash) {
+            return static_cast<std::uint8_t>(hash & 0x7F);
+        }
+
+        constexpr std::size_t map_key(const K &k) const {
+            return hash_to_index(hash_key(k));
         }
 
         constexpr void expand() {
-            auto newsz = next_capacity(_items.size());
+            rehash(next_capacity(_items.size()));
+        }
+
+        ///moves all items to new table with given capacity
+        constexpr void rehash(std::size_t newsz) {
             OpenHashMap newMap(newsz, std::move(_hasher), std::move(_eq));
             for (auto &kv : *this) {
                 newMap.try_emplace(std::move(kv.first), std::move(kv.second));
@@ -331,19 +477,89 @@ namespace ecstl {
         }
 
         constexpr bool is_occupied(std::size_t idx) const {
-            return (_stateb[idx >> 3] & (1<<(idx & 7))) != 0;
+            if constexpr(probing == OpenHashProbing::swiss) {
+                return _stateb[idx] != ctrl_group::empty;
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                return _stateb[idx*2] != 0;
+            } else {
+                return (_stateb[idx >> 3] & (1<<(idx & 7))) != 0;
+            }
         }
 
-        constexpr void set_occupied(std::size_t idx) {
-            _stateb[idx >> 3] |= (1 << (idx & 7));
+        ///marks slot occupied (linear and swiss probing, robin hood uses make_room())
+        constexpr void set_occupied(std::size_t idx, [[maybe_unused]] std::size_t hash = 0)
+                requires(probing != OpenHashProbing::robin_hood) {
+            if constexpr(probing == OpenHashProbing::swiss) {
+                set_ctrl(idx, hash_to_h2(hash));
+            } else {
+                _stateb[idx >> 3] |= (1 << (idx & 7));
+            }
         }
 
         constexpr void set_not_occupied(std::size_t idx) {
-            _stateb[idx >> 3] &= ~(1 << (idx & 7));
+            if constexpr(probing == OpenHashProbing::swiss) {
+                set_ctrl(idx, ctrl_group::empty);
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                _stateb[idx*2] = 0;
+            } else {
+                _stateb[idx >> 3] &= ~(1 << (idx & 7));
+            }
+        }
+
+        ///sets control byte, updates its mirror after end of table (swiss probing)
+        constexpr void set_ctrl(std::size_t idx, std::uint8_t v) {
+            _stateb[idx] = v;
+            if (idx < ctrl_group::width) _stateb[_items.size()+idx] = v;
+        }
+
+        ///returns index of first occupied slot at idx or after, returns capacity if none
+        constexpr std::size_t next_occupied(std::size_t idx) const {
+            if constexpr(probing != OpenHashProbing::linear) {
+                while (idx < _items.size() && !is_occupied(idx)) ++idx;
+            } else {
+                //there is always occupied bit at capacity position
+                while (!is_occupied(idx)) ++idx;
+            }
+            return idx;
+        }
+
+        ///finds free slot for the hash (swiss probing). There must be at least one free slot
+        constexpr std::size_t find_free(std::size_t hash) const {
+            auto mask = _items.size() - 1;
+            auto idx = hash_to_index(hash);
+            while (true) {
+                auto g = ctrl_group::scan(_stateb.data()+idx, 0);
+                if (g.empty) return (idx + std::countr_zero(g.empty)) & mask;
+                idx = (idx + ctrl_group::width) & mask;
+            }
+        }
+
+        ///finds key (swiss probing)
+        constexpr std::size_t find_index(const K &key, std::size_t hash) const
+                requires(probing == OpenHashProbing::swiss) {
+            auto mask = _items.size() - 1;
+            auto h2 = hash_to_h2(hash);
+            auto idx = hash_to_index(hash);
+            for (std::size_t cnt = 0; cnt < _items.size(); cnt += ctrl_group::width) {
+                auto g = ctrl_group::scan(_stateb.data()+idx, h2);
+                //key can't be after first empty slot
+                auto match = g.empty?g.match & ((g.empty & (~g.empty+1)) - 1):g.match;
+                while (match) {
+                    auto pos = (idx + std::countr_zero(match)) & mask;
+                    if (_eq(_items[pos].key_value.first, key)) return pos;
+                    match &= match - 1;
+                }
+                if (g.empty) break;
+                idx = (idx + ctrl_group::width) & mask;
+            }
+            return std::size_t(-1);
         }
 
         constexpr std::size_t find_index(const K &key) const {
             if (_items.size() == 0) return std::size_t(-1);
+            if constexpr(probing != OpenHashProbing::linear) {
+                return find_index(key, hash_key(key));
+            }
             auto idx = map_key(key);
             auto start = idx;
             do {
@@ -359,35 +575,145 @@ namespace ecstl {
             return std::size_t(-1);
         }
 
-        constexpr void try_to_fill_gap(std::size_t idx) {
-            auto pos = idx;
-            do {
-                pos = (pos + 1)%_items.size();
-                if (!is_occupied(pos)) return;  //next is hole, we are done here
-                auto org_idx = map_key(_items[pos].key_value.first);
-                if (org_idx != pos) {   //candidate
-                    //try emplace found candidate, so it should fill found gap
-                    auto res = try_emplace(_items[pos].key_value.first, std::move(_items[pos].key_value.second));
-                    //check if it was inserted - it was probably inserted to found gap
-                    if (res.second) {
-                        //however we need to erase previous position
-                        //this can create new gap
-                        erase_index(pos);
-                        return;
-                    }
-                }                
-            } while (pos != idx);
+        ///extracts 8-bit fragment of the hash stored with the item (robin hood probing)
+        static constexpr std::uint8_t hash_to_fragment(std::size_t hash) {
+            return static_cast<std::uint8_t>(hash);
+        }
+
+        ///distance stored in state byte, the largest value means "this or more" (robin hood probing)
+        static constexpr std::uint8_t saturated_distance = 255;
+
+        ///retrieves distance of occupied slot from home slot of its item, 1 - at home (robin hood probing)
+        /** Large distances don't fit to the state byte, they are computed from the hash of the key */
+        constexpr std::size_t distance_at(std::size_t idx) const requires(probing == OpenHashProbing::robin_hood) {
+            std::size_t d = _stateb[idx*2];
+            if (d != saturated_distance) return d;
+            auto home = hash_to_index(hash_key(_items[idx].key_value.first));
+            return ((idx - home) & (_items.size() - 1)) + 1;
+        }
+
+        ///stores distance and fragment of the hash of the slot (robin hood probing)
+        constexpr void set_distance(std::size_t idx, std::size_t dist, std::uint8_t frag) requires(probing == OpenHashProbing::robin_hood) {
+            _stateb[idx*2] = static_cast<std::uint8_t>(std::min<std::size_t>(dist, saturated_distance));
+            _stateb[idx*2+1] = frag;
+        }
+
+        ///finds key (robin hood probing)
+        /** Items of the table are ordered by their home slots. Search stops
+         * at an item which is closer to its home slot than the key would be */
+        constexpr std::size_t find_index(const K &key, std::size_t hash) const
+                requires(probing == OpenHashProbing::robin_hood) {
+            auto mask = _items.size() - 1;
+            auto frag = hash_to_fragment(hash);
+            auto idx = hash_to_index(hash);
+            for (std::size_t dist = 1; dist <= _items.size(); ++dist) {
+                std::size_t d = _stateb[idx*2];
+                if (d == saturated_distance && dist >= saturated_distance) d = distance_at(idx);
+                else if (d == saturated_distance) d = dist + 1;   //surely farther than the key
+                if (d < dist) break;
+                if (d == dist && _stateb[idx*2+1] == frag && _eq(_items[idx].key_value.first, key)) return idx;
+                idx = (idx + 1) & mask;
+            }
+            return std::size_t(-1);
         }
 
+        ///prepares free slot for new item with given hash (robin hood probing)
+        /**
+         * Finds the slot where the item belongs, shifts following items of the run
+         * by one slot forward and stores distance and fragment of the new item.
+         * There must be at least one free slot
+         * @return index of the slot
+         */
+        constexpr std::size_t make_room(std::size_t hash) requires(probing == OpenHashProbing::robin_hood) {
+            auto mask = _items.size() - 1;
+            auto idx = hash_to_index(hash);
+            std::size_t dist = 1;
+            //richer item or empty slot
+            while (is_occupied(idx) && distance_at(idx) >= dist) {
+                ++dist;
+                idx = (idx + 1) & mask;
+            }
+            auto last = idx;
+            while (is_occupied(last)) last = (last + 1) & mask;
+            while (last != idx) {
+                auto prev = (last + mask) & mask;
+                auto d = distance_at(prev);
+                std::construct_at(&_items[last].key_value, std::move(_items[prev].key_value));
+                std::destroy_at(&_items[prev].key_value);
+                set_distance(last, d + 1, _stateb[prev*2+1]);
+                last = prev;
+            }
+            set_distance(idx, dist, hash_to_fragment(hash));
+            return idx;
+        }
+
+        ///erases item, following items of the probe chain are shifted back
+        /**
+         * Both probing strategies place a key to the first free slot at or after
+         * its home slot, so a hole is closed by moving back the next item, whose home
+         * slot is not between the hole and the item. The move continues with
+         * the new hole until an empty slot is reached. No tombstones are needed
+         * and no item is rehashed or moved more than once.
+         */
         constexpr void erase_index(std::size_t idx) {
             if (idx >= _items.size() || !is_occupied(idx)) return;
             std::destroy_at(&_items[idx].key_value);
-            set_not_occupied(idx);
             --_size;
-            try_to_fill_gap(idx);
+            if constexpr(probing == OpenHashProbing::robin_hood) {
+                //distances are stored, shift back until an item at its home slot
+                auto mask = _items.size() - 1;
+                auto next = (idx + 1) & mask;
+                while (_stateb[next*2] > 1) {
+                    auto d = distance_at(next);
+                    std::construct_at(&_items[idx].key_value, std::move(_items[next].key_value));
+                    std::destroy_at(&_items[next].key_value);
+                    set_distance(idx, d - 1, _stateb[next*2+1]);
+                    idx = next;
+                    next = (idx + 1) & mask;
+                }
+                set_not_occupied(idx);
+            } else {
+                auto cap = _items.size();
+                auto hole = idx;
+                auto pos = idx;
+                while (true) {
+                    pos = pos + 1 == cap?0:pos + 1;
+                    if (!is_occupied(pos)) break;
+                    auto home = map_key(_items[pos].key_value.first);
+                    //distance from home to the current position vs. to the hole
+                    auto dist_pos = (pos + cap - home) % cap;
+                    auto dist_hole = (hole + cap - home) % cap;
+                    if (dist_hole > dist_pos) continue;  //the hole is before home slot
+                    std::construct_at(&_items[hole].key_value, std::move(_items[pos].key_value));
+                    std::destroy_at(&_items[pos].key_value);
+                    copy_state(pos, hole);
+                    hole = pos;
+                }
+                set_not_occupied(hole);
+            }
+        }
+
+        ///copies occupancy state (and control byte) from one slot to other
+        constexpr void copy_state(std::size_t from, std::size_t to) requires(probing != OpenHashProbing::robin_hood) {
+            if constexpr(probing == OpenHashProbing::swiss) {
+                set_ctrl(to, _stateb[from]);
+            } else {
+                set_occupied(to);
+            }
         }
 
         constexpr static FixedPrimitiveArray<std::uint8_t> initStateArray(std::size_t item_count) {            
+            if constexpr(probing == OpenHashProbing::swiss) {
+                //control bytes, first group is mirrored after end of table
+                FixedPrimitiveArray<std::uint8_t> r(item_count?item_count + ctrl_group::width:0);
+                for (auto &k : r) k = ctrl_group::empty;
+                return r;
+            } else if constexpr(probing == OpenHashProbing::robin_hood) {
+                //distance (0 - empty) and fragment of the hash
+                FixedPrimitiveArray<std::uint8_t> r(item_count*2);
+                for (auto &k : r) k = 0;
+                return r;
+            }
             FixedPrimitiveArray<std::uint8_t> r((item_count + 8)>>3);
             for (auto &k : r) k = 0;
             r[item_count >> 3] |= (1 << (item_count & 7));   
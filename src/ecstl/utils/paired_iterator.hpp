@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iterator>
+#include <compare>
 
 namespace ecstl {
 
@@ -11,10 +12,16 @@ public:
     using U_ref = decltype(*std::declval<U>());
 
     using value_type = std::pair<T_ref, U_ref>;
-    using reference = std::add_lvalue_reference_t<value_type>;
-    using pointer = std::add_pointer_t<value_type>;
+    ///pair of references is returned by value, it is cheap to construct
+    using reference = value_type;
+    ///proxy returned by operator->
+    struct pointer {
+        value_type _v;
+        constexpr value_type *operator->() {return &_v;}
+    };
     using difference_type = std::ptrdiff_t;
     using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
 
     constexpr paired_iterator() = default;
     constexpr paired_iterator(T it1, U it2) : _t_it(it1), _u_it(it2) {}
@@ -26,7 +33,6 @@ public:
         if (this != &other) {
             _t_it = other._t_it;
             _u_it = other._u_it;
-            clear_cache();
         }
         return *this;
     } 
@@ -35,7 +41,6 @@ public:
         if (this != &other) {
             _t_it = std::move(other._t_it);
             _u_it = std::move(other._u_it);
-            clear_cache();
         }
         return *this;
     } 
@@ -50,26 +55,22 @@ public:
     constexpr paired_iterator(paired_iterator<T2, U2> &&other):_t_it(std::move(other._t_it)),_u_it(std::move(other._u_it)) {}
 
     constexpr reference operator*() const {
-        fill_cache();
-        return _cache.value();
+        return reference(*_t_it, *_u_it);
     }
 
     constexpr pointer operator->() const {
-        fill_cache();
-        return &_cache.value();
+        return pointer{**this};
     }
 
     constexpr paired_iterator& operator++() {
         ++_t_it;
         ++_u_it;
-        clear_cache();
         return *this;
     }
 
     constexpr paired_iterator& operator+=(difference_type diff) {
         _t_it+=diff;
         _u_it+=diff;
-        clear_cache();
         return *this;
     }
 
@@ -82,14 +83,12 @@ public:
     constexpr paired_iterator& operator--() {
         --_t_it;
         --_u_it;
-        clear_cache();
         return *this;
     }
 
     constexpr paired_iterator& operator-=(difference_type diff) {
         _t_it-=diff;
         _u_it-=diff;
-        clear_cache();
         return *this;
     }
 
@@ -106,22 +105,35 @@ public:
         return _t_it == other._t_it || _u_it == other._u_it;
     }
 
+    constexpr std::strong_ordering operator<=>(const paired_iterator& other) const {
+        return (*this - other) <=> 0;
+    }
 
-private:
-    T _t_it = {};
-    U _u_it = {};
-    mutable std::optional<value_type> _cache = {};
+    constexpr paired_iterator operator+(difference_type diff) const {
+        paired_iterator tmp = *this;
+        tmp += diff;
+        return tmp;
+    }
 
-    constexpr void fill_cache() const {
-        if (!_cache.has_value())  {
-            _cache.emplace(*_t_it, *_u_it);
-        }
-     }
+    friend constexpr paired_iterator operator+(difference_type diff, const paired_iterator &it) {
+        return it + diff;
+    }
 
-    constexpr void clear_cache() const {
-        _cache.reset();
+    constexpr paired_iterator operator-(difference_type diff) const {
+        paired_iterator tmp = *this;
+        tmp -= diff;
+        return tmp;
     }
 
+    constexpr reference operator[](difference_type diff) const {
+        return *(*this + diff);
+    }
+
+
+private:
+    T _t_it = {};
+    U _u_it = {};
+
     template<typename , typename>
     friend class paired_iterator;
 };
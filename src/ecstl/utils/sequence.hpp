@@ -1,4 +1,6 @@
+#pragma once
 #include <tuple>
+#include <span>
 #include <utility>
 #include <type_traits>
 
@@ -51,6 +53,37 @@ constexpr auto sequence_iterate(Initial &&initial, Fn &&fn) {
     }
 }
 
+/// Fills holes in a dense array by items taken from its end
+/**
+ * Used to erase many items at once. Only items which are moved to holes are touched,
+ * so the caller updates its index only for these items
+ *
+ * @param holes positions of erased items, sorted and unique
+ * @param size current size of the array
+ * @param move function called with (from, to) for every moved item
+ * @return new size of the array, items at this position and above are to be removed
+ */
+template<typename Fn>
+constexpr std::size_t fill_holes_from_back(std::span<const std::size_t> holes, std::size_t size, Fn &&move) {
+    std::size_t new_size = size - holes.size();
+    std::size_t tail = size;
+    auto last_hole = holes.rbegin();
+    for (std::size_t h: holes) {
+        if (h >= new_size) break;
+        //find nearest item from the end, which is not erased
+        do {
+            --tail;
+            if (last_hole != holes.rend() && *last_hole == tail) {
+                ++last_hole;
+                continue;
+            }
+            break;
+        } while (true);
+        move(tail, h);
+    }
+    return new_size;
+}
+
 
 
 }
\ No newline at end of file
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "aggregate.hpp"
+#include "paired_iterator.hpp"
+#include "open_hash_map.hpp"
+#include "sequence.hpp"
+#include <vector>
+#include <span>
+#include <compare>
+
+namespace ecstl {
+
+///Proxy reference to an aggregate stored in structure of arrays
+/**
+ * Refers to fields of one item. Fields are accessible through get<I>(), the proxy also
+ * supports structured binding (auto [x,y] = ref binds references to the fields).
+ * The proxy converts to V (copies fields) and it can be assigned from V.
+ *
+ * @tparam V aggregate type
+ * @tparam is_const true if fields are read-only
+ */
+template<typename V, bool is_const>
+class soa_ref {
+public:
+
+    using Fields = aggregate_fields_t<V>;
+
+    template<std::size_t I>
+    using field_type = std::conditional_t<is_const, const std::tuple_element_t<I, Fields>, std::tuple_element_t<I, Fields> >;
+
+    constexpr soa_ref(const soa_ref &) = default;
+
+    template<typename Refs>
+    requires(!std::is_same_v<std::remove_cvref_t<Refs>, soa_ref>)
+    constexpr explicit soa_ref(Refs &&refs):_refs(std::forward<Refs>(refs)) {}
+
+    ///Access to a field
+    template<std::size_t I>
+    constexpr field_type<I> &get() const {
+        return std::get<I>(_refs);
+    }
+
+    ///Copy fields to the aggregate
+    constexpr operator V() const {
+        return std::apply([](auto & ... f){return V{f...};}, _refs);
+    }
+
+    ///Assign all fields
+    constexpr const soa_ref &operator=(const V &v) const requires(!is_const) {
+        std::apply([&](const auto & ... src){
+            std::apply([&](auto & ... dst){((dst = src),...);}, _refs);
+        }, aggregate_tie(v));
+        return *this;
+    }
+
+    ///Assign all fields from other item
+    constexpr const soa_ref &operator=(const soa_ref &other) const requires(!is_const) {
+        std::apply([&](const auto & ... src){
+            std::apply([&](auto & ... dst){((dst = src),...);}, _refs);
+        }, other._refs);
+        return *this;
+    }
+
+    ///Convert to read-only proxy
+    constexpr operator soa_ref<V, true>() const requires(!is_const) {
+        return soa_ref<V, true>(_refs);
+    }
+
+protected:
+    template<typename Tuple>
+    struct make_refs;
+    template<typename ... Fs>
+    struct make_refs<std::tuple<Fs...> > {
+        using type = std::tuple<std::conditional_t<is_const, const Fs &, Fs &>...>;
+    };
+
+    typename make_refs<Fields>::type _refs;
+};
+
+///Random access iterator over structure of arrays, dereference returns soa_ref
+template<typename V, bool is_const>
+class soa_iterator {
+public:
+
+    using Fields = aggregate_fields_t<V>;
+    using value_type = soa_ref<V, is_const>;
+    using reference = soa_ref<V, is_const>;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+
+    template<typename Tuple>
+    struct make_ptrs;
+    template<typename ... Fs>
+    struct make_ptrs<std::tuple<Fs...> > {
+        using type = std::tuple<std::conditional_t<is_const, const Fs *, Fs *>...>;
+    };
+    using Pointers = typename make_ptrs<Fields>::type;
+
+    constexpr soa_iterator() = default;
+    constexpr explicit soa_iterator(Pointers ptrs):_ptrs(ptrs) {}
+
+    constexpr operator soa_iterator<V, true>() const requires(!is_const) {
+        return soa_iterator<V, true>(_ptrs);
+    }
+
+    constexpr reference operator*() const {
+        return reference(std::apply([](auto ... p){return std::tie(*p...);}, _ptrs));
+    }
+    constexpr reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+    constexpr soa_iterator &operator+=(difference_type n) {
+        std::apply([&](auto & ... p){((p += n),...);}, _ptrs);
+        return *this;
+    }
+    constexpr soa_iterator &operator-=(difference_type n) {
+        return *this += -n;
+    }
+    constexpr soa_iterator &operator++() {return *this += 1;}
+    constexpr soa_iterator &operator--() {return *this -= 1;}
+    constexpr soa_iterator operator++(int) {
+        auto save = *this;
+        ++(*this);
+        return save;
+    }
+    constexpr soa_iterator operator--(int) {
+        auto save = *this;
+        --(*this);
+        return save;
+    }
+    constexpr soa_iterator operator+(difference_type n) const {
+        auto r = *this;
+        r += n;
+        return r;
+    }
+    friend constexpr soa_iterator operator+(difference_type n, const soa_iterator &it) {
+        return it + n;
+    }
+    constexpr soa_iterator operator-(difference_type n) const {
+        auto r = *this;
+        r -= n;
+        return r;
+    }
+    constexpr difference_type operator-(const soa_iterator &other) const {
+        return std::get<0>(_ptrs) - std::get<0>(other._ptrs);
+    }
+    constexpr bool operator==(const soa_iterator &other) const {
+        return std::get<0>(_ptrs) == std::get<0>(other._ptrs);
+    }
+    constexpr std::strong_ordering operator<=>(const soa_iterator &other) const {
+        return (*this - other) <=> 0;
+    }
+
+protected:
+    Pointers _ptrs = {};
+
+    template<typename, bool>
+    friend class soa_iterator;
+};
+
+
+///Flat map with dense keys, values are aggregates stored as structure of arrays
+/**
+ * Has the same interface as IndexedFlatMap, but each field of V is stored in its
+ * own vector. Iterators return pair of key and soa_ref proxy. Loops over a single field
+ * (see column()) touch only memory of that field and can be vectorized.
+ *
+ * @tparam K key type
+ * @tparam V value type, must be an aggregate (see aggregate_arity)
+ * @tparam Hasher hash function
+ * @tparam Equal equality of keys
+ */
+template<typename K, typename V, typename Hasher = std::hash<K>, typename Equal = std::equal_to<K> >
+class SoaFlatMap {
+public:
+
+    using Fields = aggregate_fields_t<V>;
+    static_assert(std::tuple_size_v<Fields> > 0, "Aggregate must have at least one field");
+
+    using const_primitive_iterator_key = const K *;
+
+    using iterator = paired_iterator<const_primitive_iterator_key, soa_iterator<V, false> >;
+    using const_iterator = paired_iterator<const_primitive_iterator_key, soa_iterator<V, true> >;
+    using insert_result = std::pair<iterator, bool>;
+
+    template<typename Key, typename ... Args>
+    requires (std::is_constructible_v<K, Key> && std::is_constructible_v<V, Args...>)
+    constexpr insert_result try_emplace(Key &&key, Args && ... args) {
+        auto iter = _index.find(key);
+        if (iter != _index.end()) {
+            return insert_result(build_iterator(iter->second), false);
+        }
+        auto pos = _keys.size();
+        _keys.emplace_back(std::forward<Key>(key));
+        V tmp(std::forward<Args>(args)...);
+        for_each_column([&](auto &col, auto idx){
+            col.push_back(std::move(std::get<idx>(aggregate_tie(tmp))));
+        });
+        _index.emplace(_keys.back(), pos);
+        return insert_result(build_iterator(pos), true);
+    }
+
+    template<typename Key, typename ... Args>
+    requires(std::is_constructible_v<K, Key> && std::is_constructible_v<V, Args...>)
+    constexpr auto emplace(Key &&key, Args && ... args) {
+        return try_emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+    }
+
+    constexpr iterator begin() {return build_iterator(0);}
+    constexpr iterator end() {return build_iterator(_keys.size());}
+    constexpr const_iterator cbegin() const {return build_iterator(0);}
+    constexpr const_iterator cend() const {return build_iterator(_keys.size());}
+    constexpr const_iterator begin() const {return build_iterator(0);}
+    constexpr const_iterator end() const {return build_iterator(_keys.size());}
+
+    constexpr iterator find(const K &key) {
+        auto iter = _index.find(key);
+        if (iter == _index.end()) return end();
+        return build_iterator(iter->second);
+    }
+
+    constexpr const_iterator find(const K &key) const {
+        auto iter = _index.find(key);
+        if (iter == _index.end()) return end();
+        return build_iterator(iter->second);
+    }
+
+    constexpr bool erase(const K &key) {
+        auto iter = _index.find(key);
+        if (iter == _index.end()) return false;
+        std::size_t pos = iter->second;
+        _index.erase(iter);
+        if (pos+1 < _keys.size()) {
+            _index[_keys.back()] = pos;
+            _keys[pos] = std::move(_keys.back());
+            for_each_column([&](auto &col, auto){
+                col[pos] = std::move(col.back());
+            });
+        }
+        _keys.pop_back();
+        for_each_column([&](auto &col, auto){col.pop_back();});
+        return true;
+    }
+
+    ///Erases items at given positions at once
+    /**
+     * @param positions positions of items, sorted and unique
+     *
+     * Holes are filled by items from the end, the index is updated only for moved items
+     */
+    constexpr void erase_at(std::span<const std::size_t> positions) {
+        for (std::size_t pos: positions) _index.erase(_keys[pos]);
+        auto new_size = fill_holes_from_back(positions, _keys.size(), [&](std::size_t from, std::size_t to){
+            _keys[to] = std::move(_keys[from]);
+            for_each_column([&](auto &col, auto){
+                col[to] = std::move(col[from]);
+            });
+            _index.find(_keys[to])->second = to;
+        });
+        _keys.erase(_keys.begin() + new_size, _keys.end());
+        for_each_column([&](auto &col, auto){col.erase(col.begin() + new_size, col.end());});
+    }
+
+    constexpr iterator erase(iterator it) {
+        erase(it->first);
+        return it;
+    }
+    constexpr const_iterator erase(const_iterator it) {
+        erase(it->first);
+        return it;
+    }
+
+    constexpr insert_result insert(std::pair<K, V> it) {
+        return try_emplace(std::move(it.first), std::move(it.second));
+    }
+
+    constexpr std::size_t size() const {return _keys.size();}
+    ///count of items which can be stored without reallocation
+    constexpr std::size_t capacity() const {return _keys.capacity();}
+
+    constexpr void reserve(std::size_t sz) {
+        _keys.reserve(sz);
+        _index.reserve(sz);
+        for_each_column([&](auto &col, auto){col.reserve(sz);});
+    }
+
+    constexpr void clear() {
+        _keys.clear();
+        for_each_column([&](auto &col, auto){col.clear();});
+        _index.clear();
+    }
+
+    ///Swaps two items at given positions (index is updated)
+    constexpr void swap_items(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        std::swap(_keys[a], _keys[b]);
+        for_each_column([&](auto &col, auto){std::swap(col[a], col[b]);});
+        _index.find(_keys[a])->second = a;
+        _index.find(_keys[b])->second = b;
+    }
+
+    ///Retrieve all values of a field as contiguous array
+    /**
+     * @tparam I index of the field
+     * @return span, items are in the same order as keys (see keys())
+     */
+    template<std::size_t I>
+    constexpr std::span<std::tuple_element_t<I, Fields> > column() {
+        return std::get<I>(_columns);
+    }
+
+    template<std::size_t I>
+    constexpr std::span<const std::tuple_element_t<I, Fields> > column() const {
+        return std::get<I>(_columns);
+    }
+
+    ///Retrieve all keys as contiguous array
+    constexpr std::span<const K> keys() const {
+        return _keys;
+    }
+
+protected:
+
+    template<typename Tuple>
+    struct make_columns;
+    template<typename ... Fs>
+    struct make_columns<std::tuple<Fs...> > {
+        using type = std::tuple<std::vector<Fs>...>;
+    };
+
+    OpenHashMap<K, std::size_t, Hasher, Equal> _index;
+    std::vector<K> _keys;
+    typename make_columns<Fields>::type _columns;
+
+    template<typename Fn>
+    constexpr void for_each_column(Fn &&fn) {
+        sequence_iterate<std::tuple_size_v<Fields> >([&](auto idx){
+            fn(std::get<idx>(_columns), idx);
+        });
+    }
+
+    constexpr iterator build_iterator(std::size_t pos) {
+        auto ptrs = std::apply([&](auto & ... col){
+            return typename soa_iterator<V, false>::Pointers(col.data()+pos...);
+        }, _columns);
+        return iterator(_keys.data()+pos, soa_iterator<V, false>(ptrs));
+    }
+
+    constexpr const_iterator build_iterator(std::size_t pos) const {
+        auto ptrs = std::apply([&](const auto & ... col){
+            return typename soa_iterator<V, true>::Pointers(col.data()+pos...);
+        }, _columns);
+        return const_iterator(_keys.data()+pos, soa_iterator<V, true>(ptrs));
+    }
+};
+
+}
+
+template<typename V, bool is_const>
+struct std::tuple_size<ecstl::soa_ref<V, is_const> >
+    : std::tuple_size<ecstl::aggregate_fields_t<V> > {};
+
+template<std::size_t I, typename V, bool is_const>
+struct std::tuple_element<I, ecstl::soa_ref<V, is_const> > {
+    using type = typename ecstl::soa_ref<V, is_const>::template field_type<I>;
+};
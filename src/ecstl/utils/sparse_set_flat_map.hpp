@@ -0,0 +1,202 @@
+#pragma once
+
+#include "paired_iterator.hpp"
+#include "sequence.hpp"
+#include <vector>
+#include <span>
+#include <functional>
+
+namespace ecstl {
+
+///Flat map with dense keys and values, indexed by paged sparse array
+/**
+ * Has the same interface as IndexedFlatMap, but instead of hash table, the
+ * position of the key is resolved through a sparse array indexed directly by the key's
+ * numeric identifier. Lookup is just two memory loads, no hashing or probing.
+ *
+ * @tparam K key type
+ * @tparam V value type
+ * @tparam Hasher function which converts key to numeric identifier. Keys stored
+ * at the same time must have different identifiers (lookup compares the stored key,
+ * a key sharing the identifier with a stored key is not found and must not be inserted). The identifiers
+ * should be dense (small numbers), because the sparse array grows with the
+ * highest identifier (allocated by pages). Entity ids created by Entity::create() satisfy this
+ * @tparam Equal equality of keys
+ */
+template<typename K, typename V, typename Hasher = std::hash<K>, typename Equal = std::equal_to<K> >
+class SparseSetFlatMap {
+public:
+
+    using VectorK = std::vector<K>;
+    using VectorV = std::vector<V>;
+
+    using const_primitive_iterator_key = const K *;
+    using const_primitive_iterator_value = const V *;
+    using primitive_iterator_value = V *;
+
+    using iterator = paired_iterator<const_primitive_iterator_key, primitive_iterator_value>;
+    using const_iterator = paired_iterator<const_primitive_iterator_key, const_primitive_iterator_value>;
+    using insert_result = std::pair<iterator, bool>;
+
+    ///count of slots in a single page of the sparse array
+    static constexpr std::size_t page_size = 1024;
+
+
+    ///Inserts the item if the key is not stored yet
+    /**
+     * @return iterator to the item and true if inserted. If other key with the
+     * same identifier is stored, nothing is inserted and the function returns end() and false
+     */
+    template<typename Key, typename ... Args>
+    requires (std::is_constructible_v<K, Key> && std::is_constructible_v<V, Args...>)
+    constexpr insert_result try_emplace(Key &&key, Args && ... args) {
+        std::size_t &slot = sparse_slot(key);
+        if (slot != npos) {
+            if (!_eq(_keys[slot], key)) return insert_result(end(), false);
+            return insert_result(build_iterator(slot), false);
+        }
+        auto pos = _keys.size();
+        _keys.emplace_back(std::forward<Key>(key));
+        _values.emplace_back(std::forward<Args>(args)...);
+        slot = pos;
+        return insert_result(build_iterator(pos), true);
+    }
+
+    template<typename Key, typename ... Args>
+    requires(std::is_constructible_v<K, Key> && std::is_constructible_v<V, Args...>)
+    constexpr auto emplace(Key &&key, Args && ... args) {
+        return try_emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+    }
+
+    constexpr iterator begin() {return build_iterator(0);}
+    constexpr iterator end() {return build_iterator(_keys.size());}
+    constexpr const_iterator cbegin() const {return build_iterator(0);}
+    constexpr const_iterator cend() const {return build_iterator(_keys.size());}
+    constexpr const_iterator begin() const {return build_iterator(0);}
+    constexpr const_iterator end() const {return build_iterator(_keys.size());}
+
+    constexpr iterator find(const K &key) {
+        auto pos = find_pos(key);
+        if (pos == npos) return end();
+        return build_iterator(pos);
+    }
+
+    constexpr const_iterator find(const K &key) const {
+        auto pos = find_pos(key);
+        if (pos == npos) return end();
+        return build_iterator(pos);
+    }
+
+    constexpr bool erase(const K &key) {
+        auto pos = find_pos(key);
+        if (pos == npos) return false;
+        sparse_slot(key) = npos;
+        if (pos+1 < _keys.size()) {
+            sparse_slot(_keys.back()) = pos;
+            _keys[pos] = std::move(_keys.back());
+            _values[pos] = std::move(_values.back());
+        }
+        _keys.pop_back();
+        _values.pop_back();
+        return true;
+    }
+
+    ///Erases items at given positions at once
+    /**
+     * @param positions positions of items, sorted and unique
+     *
+     * Holes are filled by items from the end, the sparse array is updated only for moved items
+     */
+    constexpr void erase_at(std::span<const std::size_t> positions) {
+        for (std::size_t pos: positions) sparse_slot(_keys[pos]) = npos;
+        auto new_size = fill_holes_from_back(positions, _keys.size(), [&](std::size_t from, std::size_t to){
+            _keys[to] = std::move(_keys[from]);
+            _values[to] = std::move(_values[from]);
+            sparse_slot(_keys[to]) = to;
+        });
+        _keys.erase(_keys.begin() + new_size, _keys.end());
+        _values.erase(_values.begin() + new_size, _values.end());
+    }
+
+    constexpr iterator erase(iterator it) {
+        erase(it->first);
+        return it;
+    }
+    constexpr const_iterator erase(const_iterator it) {
+        erase(it->first);
+        return it;
+    }
+
+    constexpr insert_result insert(std::pair<K, V> it) {
+        return try_emplace(std::move(it.first), std::move(it.second));
+    }
+
+    constexpr std::size_t size() const {return _keys.size();}
+
+    constexpr void reserve(std::size_t sz) {
+        _keys.reserve(sz);
+        _values.reserve(sz);
+    }
+
+    constexpr void clear() {
+        _keys.clear();
+        _values.clear();
+        _pages.clear();
+    }
+
+    ///Swaps two items at given positions (index is updated)
+    constexpr void swap_items(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        std::swap(_keys[a], _keys[b]);
+        std::swap(_values[a], _values[b]);
+        sparse_slot(_keys[a]) = a;
+        sparse_slot(_keys[b]) = b;
+    }
+
+    ///Retrieve all keys as contiguous array
+    constexpr std::span<const K> keys() const {return _keys;}
+    ///Retrieve all values as contiguous array, items are in the same order as keys
+    constexpr std::span<V> values() {return _values;}
+    ///Retrieve all values as contiguous array, items are in the same order as keys
+    constexpr std::span<const V> values() const {return _values;}
+
+protected:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    [[no_unique_address]] Hasher _hasher = {};
+    [[no_unique_address]] Equal _eq = {};
+    std::vector<std::vector<std::size_t> > _pages;
+    std::vector<K> _keys;
+    std::vector<V> _values;
+
+    constexpr std::size_t find_pos(const K &key) const {
+        std::size_t id = _hasher(key);
+        std::size_t page = id / page_size;
+        if (page >= _pages.size() || _pages[page].empty()) return npos;
+        std::size_t pos = _pages[page][id % page_size];
+        if (pos == npos || !_eq(_keys[pos], key)) return npos;
+        return pos;
+    }
+
+    ///retrieves slot for the key, allocates page if needed
+    constexpr std::size_t &sparse_slot(const K &key) {
+        std::size_t id = _hasher(key);
+        std::size_t page = id / page_size;
+        if (page >= _pages.size()) _pages.resize(page+1);
+        auto &p = _pages[page];
+        if (p.empty()) p.resize(page_size, npos);
+        return p[id % page_size];
+    }
+
+    constexpr iterator build_iterator(std::size_t pos) {
+        return iterator(_keys.data()+pos, _values.data()+pos);
+    }
+
+    constexpr const_iterator build_iterator(std::size_t pos) const {
+        return const_iterator(_keys.data()+pos, _values.data()+pos);
+    }
+
+};
+
+
+}
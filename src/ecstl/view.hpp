@@ -1,11 +1,17 @@
 #pragma once
 #include "component.hpp"
 #include "utils/sequence.hpp"
+#include "utils/optional_ref.hpp"
 #include <tuple>
 #include <limits>
 #include <array>
 #include <optional>
 #include <span>
+#include <ranges>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 namespace ecstl {
 
@@ -50,6 +56,568 @@ namespace ecstl {
         return ptr?ptr->find(key):X();
     }   
 
+    ///Pointer to a pool which can be grouped with other pools (see PoolGroup)
+    template<typename T>
+    concept HasPoolGroup = requires(const T &p) {
+        {p->get_group()} -> std::convertible_to<PoolGroup>;
+    };
+
+    ///Executor which can run tasks in other threads (for example AsyncSignalDispatcher)
+    template<typename T>
+    concept ViewExecutor = requires(T &e) {
+        e.dispatch([]() noexcept {});
+    };
+
+    ///Splits range of positions into chunks and processes them in parallel
+    /**
+     * @param executor executor which runs helper tasks. The calling thread processes chunks as
+     * well, so the function completes even if the executor doesn't run the tasks.
+     * If the executor declares thread_count, no more tasks than threads are dispatched
+     * @param total count of positions
+     * @param chunk_size count of positions in one chunk
+     * @param fn function called as fn(begin, end) for each chunk
+     *
+     * The function returns after all chunks are processed
+     */
+    template<ViewExecutor Exec, typename Fn>
+    void parallel_for_chunks(Exec &executor, std::size_t total, std::size_t chunk_size, Fn &&fn) {
+        if (total == 0) return;
+        if (chunk_size == 0) chunk_size = 1;
+        std::size_t chunks = (total + chunk_size - 1) / chunk_size;
+
+        struct State {
+            std::atomic<std::size_t> next = 0;
+            std::size_t done = 0;
+            std::mutex mx;
+            std::condition_variable cv;
+        };
+        auto st = std::make_shared<State>();
+        //worker which came too late doesn't touch anything except the state
+        auto worker = [st, chunks, chunk_size, total, fnp = &fn]() noexcept {
+            std::size_t cnt = 0;
+            while (true) {
+                std::size_t c = st->next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks) break;
+                std::size_t b = c * chunk_size;
+                (*fnp)(b, std::min(b + chunk_size, total));
+                ++cnt;
+            }
+            if (cnt) {
+                std::lock_guard _(st->mx);
+                st->done += cnt;
+                if (st->done == chunks) st->cv.notify_all();
+            }
+        };
+        std::size_t helpers = chunks - 1;
+        if constexpr(requires {Exec::thread_count;}) {
+            helpers = std::min<std::size_t>(helpers, Exec::thread_count);
+        }
+        for (std::size_t i = 0; i < helpers; ++i) {
+            executor.dispatch(decltype(worker)(worker));
+        }
+        worker();
+        std::unique_lock lk(st->mx);
+        st->cv.wait(lk, [&]{return st->done == chunks;});
+    }
+
+    ///Calls function with a row of a view, the row is passed as tuple or as separate arguments
+    template<typename Fn, typename Row>
+    constexpr void invoke_with_row(Fn &fn, Row &&row) {
+        if constexpr(std::is_invocable_v<Fn &, Row>) {
+            fn(std::forward<Row>(row));
+        } else {
+            std::apply(fn, std::forward<Row>(row));
+        }
+    }
+
+    ///Pointer to a pool which exposes its keys and values as contiguous arrays
+    template<typename T>
+    concept HasColumns = requires(const T &p) {
+        {p->keys()};
+        {p->values()};
+    };
+
+    ///Aligned arrays of entities and components
+    /**
+     * Item at the index i of every span belongs to the entity at the index i
+     * @tparam Ts component types (const qualified for read-only access)
+     */
+    template<typename ... Ts>
+    struct ViewColumns {
+        std::span<const Entity> entities;
+        std::tuple<std::span<Ts>...> values;
+
+        constexpr std::size_t size() const {return entities.size();}
+
+        ///Retrieve values of I-th component
+        template<std::size_t I>
+        constexpr auto get() const {return std::get<I>(values);}
+    };
+
+    ///Pointer to a pool which stores change ticks (see ChangeTrackedMap)
+    template<typename T>
+    concept HasChangeTicks = requires(const T &p) {
+        {p->ticks()} -> std::convertible_to<std::span<const ChangeTicks> >;
+    };
+
+    ///Rows of a view filtered by change ticks
+    /**
+     * Returned by View::changed_since() and View::added_since(). A row passes when
+     * at least one of its tracked components (see has_change_tracking) has the tick greater
+     * or equal to the given tick. Components which don't track changes are ignored.
+     *
+     * The rows are filtered during iteration, the ticks are read from an array aligned with
+     * the pool, so the check doesn't need any lookup.
+     *
+     * @tparam BaseView View or DenseView
+     */
+    template<typename BaseView>
+    class ChangedView: public std::ranges::view_interface<ChangedView<BaseView> > {
+    public:
+
+        using PoolsTuple = typename BaseView::PoolsTuple;
+        using BaseIterator = decltype(std::declval<const BaseView &>().begin());
+        using BaseSentinel = decltype(std::declval<const BaseView &>().end());
+
+        class Sentinel {};
+
+        class Iterator {
+        public:
+            using value_type = typename BaseIterator::value_type;
+            using reference = typename BaseIterator::reference;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+
+            constexpr Iterator() = default;
+            constexpr Iterator(const ChangedView *owner, BaseIterator iter, BaseSentinel end)
+                :_owner(owner), _iter(std::move(iter)), _end(std::move(end)) {
+                skip();
+            }
+
+            constexpr reference operator*() const {return *_iter;}
+
+            constexpr Iterator &operator++() {
+                ++_iter;
+                skip();
+                return *this;
+            }
+
+            constexpr Iterator operator++(int) {
+                auto save = *this;
+                ++(*this);
+                return save;
+            }
+
+            constexpr bool operator==(const Iterator &other) const {
+                return _iter == other._iter;
+            }
+
+            constexpr bool operator==(const Sentinel &) const {
+                return _iter == _end;
+            }
+
+        protected:
+            const ChangedView *_owner = nullptr;
+            BaseIterator _iter = {};
+            BaseSentinel _end = {};
+
+            constexpr void skip() {
+                while (!(_iter == _end) && !_owner->matches(_iter)) ++_iter;
+            }
+        };
+
+        constexpr ChangedView() = default;
+
+        ///Construct the filter
+        /**
+         * @param base filtered view
+         * @param pools pools of the view
+         * @param tick minimal tick
+         * @param added true to test tick of insertion, false to test tick of last change
+         */
+        constexpr ChangedView(BaseView base, PoolsTuple pools, ChangeTick tick, bool added)
+            :_base(std::move(base)), _pools(std::move(pools)), _tick(tick), _added(added) {}
+
+        constexpr Iterator begin() const {return Iterator(this, _base.begin(), _base.end());}
+        constexpr Sentinel end() const {return {};}
+
+    protected:
+        BaseView _base = {};
+        PoolsTuple _pools = {};
+        ChangeTick _tick = 0;
+        bool _added = false;
+
+        constexpr bool matches(const BaseIterator &iter) const {
+            const auto &iters = iter.iterators();
+            return sequence_iterate<std::tuple_size_v<PoolsTuple> >(false, [&](bool r, auto idx){
+                if constexpr(HasChangeTicks<std::tuple_element_t<idx, PoolsTuple> >) {
+                    if (r) return r;
+                    auto &p = std::get<idx>(_pools);
+                    auto pos = static_cast<std::size_t>(std::get<idx>(iters) - safe_begin(p));
+                    const ChangeTicks &t = p->ticks()[pos];
+                    return (_added?t.added:t.changed) >= _tick;
+                } else {
+                    return r;
+                }
+            });
+        }
+    };
+
+    ///Components which must not be present on the entity (see GenericRegistry::view())
+    template<typename ... Ts>
+    struct Exclude {};
+
+    ///Components which can be missing on the entity (see GenericRegistry::view())
+    template<typename ... Ts>
+    struct Optional {};
+
+    ///Checks whether T is Exclude or Optional list
+    template<typename T>
+    constexpr bool is_view_filter = false;
+    template<typename ... Ts>
+    constexpr bool is_view_filter<Exclude<Ts...> > = true;
+    template<typename ... Ts>
+    constexpr bool is_view_filter<Optional<Ts...> > = true;
+
+    namespace _details {
+        template<typename T> struct required_of {using type = std::tuple<T>;};
+        template<typename ... Ts> struct required_of<Exclude<Ts...> > {using type = std::tuple<>;};
+        template<typename ... Ts> struct required_of<Optional<Ts...> > {using type = std::tuple<>;};
+        template<typename T> struct excluded_of {using type = std::tuple<>;};
+        template<typename ... Ts> struct excluded_of<Exclude<Ts...> > {using type = std::tuple<Ts...>;};
+        template<typename T> struct optional_of {using type = std::tuple<>;};
+        template<typename ... Ts> struct optional_of<Optional<Ts...> > {using type = std::tuple<Ts...>;};
+
+        template<typename ... Tuples> struct tuple_concat {using type = std::tuple<>;};
+        template<typename ... As> struct tuple_concat<std::tuple<As...> > {using type = std::tuple<As...>;};
+        template<typename ... As, typename ... Bs, typename ... Rest>
+        struct tuple_concat<std::tuple<As...>, std::tuple<Bs...>, Rest...>
+            : tuple_concat<std::tuple<As..., Bs...>, Rest...> {};
+    }
+
+    ///Splits component list of a view to required, excluded and optional components
+    template<typename ... Components>
+    struct ViewComponents {
+        using Required = typename _details::tuple_concat<typename _details::required_of<Components>::type...>::type;
+        using Excluded = typename _details::tuple_concat<typename _details::excluded_of<Components>::type...>::type;
+        using Optionals = typename _details::tuple_concat<typename _details::optional_of<Components>::type...>::type;
+    };
+
+    ///Finds component of an entity in a pool, returns empty reference if not found
+    /**
+     * @return OptionalRef to the component. Not available for pools stored as structure of arrays
+     */
+    template<IsPointerLike Pool>
+    constexpr auto find_optional(const Pool &p, const Entity &e) {
+        using V = decltype(p->begin()->second);
+        static_assert(!is_soa_ref<V>, "Component with ComponentLayout::soa cannot be optional");
+        using R = OptionalRef<std::remove_reference_t<V> >;
+        if (!p) return R();
+        auto iter = p->find(e);
+        if (iter == p->end()) return R();
+        return R(iter->second);
+    }
+
+    ///Rows of a view without entities of excluded pools, extended by optional components
+    /**
+     * Returned by GenericRegistry::view() when the component list contains Exclude or Optional.
+     * Pools are resolved when the view is created, so the test of each row is a direct
+     * lookup in the pool. Optional components are appended to the row as OptionalRef
+     * (components with ComponentLayout::soa cannot be optional)
+     *
+     * @tparam BaseView view of required components (View or DenseView)
+     * @tparam ExcludedPools tuple of pointers to pools of excluded components (can be null)
+     * @tparam OptionalPools tuple of pointers to pools of optional components (can be null)
+     */
+    template<typename BaseView, typename ExcludedPools, typename OptionalPools>
+    class FilteredView: public std::ranges::view_interface<FilteredView<BaseView, ExcludedPools, OptionalPools> > {
+    public:
+
+        using BaseIterator = decltype(std::declval<const BaseView &>().begin());
+        using BaseSentinel = decltype(std::declval<const BaseView &>().end());
+        using Values = decltype(std::tuple_cat(std::declval<typename BaseIterator::reference>(),
+                std::apply([](const auto & ... p){
+                    return std::make_tuple(find_optional(p, Entity())...);
+                }, std::declval<const OptionalPools &>())));
+
+        class Sentinel {};
+
+        class Iterator {
+        public:
+            using value_type = Values;
+            using reference = Values;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+
+            constexpr Iterator() = default;
+            constexpr Iterator(const FilteredView *owner, BaseIterator iter, BaseSentinel end)
+                :_owner(owner), _iter(std::move(iter)), _end(std::move(end)) {
+                skip();
+            }
+
+            constexpr reference operator*() const {
+                auto row = *_iter;
+                const Entity &e = std::get<0>(row);
+                return std::tuple_cat(row, std::apply([&](const auto & ... p){
+                    return std::make_tuple(find_optional(p, e)...);
+                }, _owner->_optional));
+            }
+
+            constexpr Iterator &operator++() {
+                ++_iter;
+                skip();
+                return *this;
+            }
+
+            constexpr Iterator operator++(int) {
+                auto save = *this;
+                ++(*this);
+                return save;
+            }
+
+            constexpr bool operator==(const Iterator &other) const {
+                return _iter == other._iter;
+            }
+
+            constexpr bool operator==(const Sentinel &) const {
+                return _iter == _end;
+            }
+
+        protected:
+            const FilteredView *_owner = nullptr;
+            BaseIterator _iter = {};
+            BaseSentinel _end = {};
+
+            constexpr void skip() {
+                while (!(_iter == _end) && _owner->excluded(std::get<0>(*_iter))) ++_iter;
+            }
+        };
+
+        constexpr FilteredView() = default;
+        constexpr FilteredView(BaseView base, ExcludedPools excluded, OptionalPools optional)
+            :_base(std::move(base)), _excluded(std::move(excluded)), _optional(std::move(optional)) {}
+
+        constexpr Iterator begin() const {return Iterator(this, _base.begin(), _base.end());}
+        constexpr Sentinel end() const {return {};}
+
+    protected:
+        BaseView _base = {};
+        ExcludedPools _excluded = {};
+        OptionalPools _optional = {};
+
+        ///returns true if the entity is in an excluded pool
+        constexpr bool excluded(const Entity &e) const {
+            return std::apply([&](const auto & ... p){
+                return ((p && p->find(e) != p->end()) || ...);
+            }, _excluded);
+        }
+    };
+
+    ///A view above pools where all pools contain the same sequence of entities
+    /**
+     * The rows are iterated in lockstep without any lookup. The view is
+     * a sized random access range, so it can be used with parallel algorithms,
+     * or split into chunks. The rows can't be permuted through the view (the entity
+     * is const), so it can't be sorted by std::ranges::sort.
+     *
+     * This view is used by View for a single pool and it is returned by View::dense()
+     * when the pools are fully grouped.
+     *
+     * @tparam PoolsTuple a tuple of pointer or pointer-like objects with pools
+     */
+    template<typename PoolsTuple>
+    class DenseView;
+
+    template<IsPointerLike ... Pools>
+    class DenseView<std::tuple<Pools...> >: public std::ranges::view_interface<DenseView<std::tuple<Pools... > > >{
+    public:
+
+        using PoolsTuple = std::tuple<Pools...>;
+        using Iterators = std::tuple<decltype(std::declval<Pools&>()->begin())...>;
+        using Values = std::tuple<const Entity &, decltype(std::declval<Pools&>()->begin()->second)...>;
+        using Offsets = std::array<std::size_t, sizeof...(Pools)>;
+
+        class Iterator {
+        public:
+            using value_type = Values;
+            using reference = Values;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept = std::random_access_iterator_tag;
+
+            constexpr Iterator() = default;
+            constexpr Iterator(Iterators iters):_iters(std::move(iters)) {}
+
+            constexpr reference operator*() const {
+                const Entity &ent = std::get<0>(_iters)->first;
+                return std::apply([&](auto &... iters){return Values(ent,iters->second...);}, _iters);
+            }
+
+            constexpr reference operator[](difference_type n) const {
+                return *(*this + n);
+            }
+
+            constexpr Iterator &operator+=(difference_type n) {
+                std::apply([&](auto &... iters){((iters += n),...);}, _iters);
+                return *this;
+            }
+
+            constexpr Iterator &operator-=(difference_type n) {
+                return *this += -n;
+            }
+
+            constexpr Iterator &operator++() {
+                std::apply([&](auto &... iters){(++iters,...);}, _iters);
+                return *this;
+            }
+
+            constexpr Iterator &operator--() {
+                std::apply([&](auto &... iters){(--iters,...);}, _iters);
+                return *this;
+            }
+
+            constexpr Iterator operator++(int) {
+                auto save = *this;
+                ++(*this);
+                return save;
+            }
+
+            constexpr Iterator operator--(int) {
+                auto save = *this;
+                --(*this);
+                return save;
+            }
+
+            constexpr Iterator operator+(difference_type n) const {
+                auto r = *this;
+                r += n;
+                return r;
+            }
+
+            friend constexpr Iterator operator+(difference_type n, const Iterator &it) {
+                return it + n;
+            }
+
+            constexpr Iterator operator-(difference_type n) const {
+                auto r = *this;
+                r -= n;
+                return r;
+            }
+
+            constexpr difference_type operator-(const Iterator &other) const {
+                return std::get<0>(_iters) - std::get<0>(other._iters);
+            }
+
+            constexpr bool operator==(const Iterator &other) const {
+                return std::get<0>(_iters) == std::get<0>(other._iters);
+            }
+
+            constexpr std::strong_ordering operator<=>(const Iterator &other) const {
+                return (*this - other) <=> 0;
+            }
+
+            ///Retrieve iterators of all pools
+            constexpr const Iterators &iterators() const {return _iters;}
+
+        protected:
+            Iterators _iters = {};
+        };
+
+        constexpr DenseView() = default;
+
+        ///Construct view over whole single pool (size follows the pool)
+        constexpr DenseView(PoolsTuple pools) requires(sizeof...(Pools) == 1)
+            :_pools(std::move(pools)), _whole(true) {}
+
+        ///Construct view over ranges of pools
+        /**
+         * @param pools pools
+         * @param begins starting position in each pool
+         * @param size count of rows
+         */
+        constexpr DenseView(PoolsTuple pools, Offsets begins, std::size_t size)
+            :_pools(std::move(pools)), _begins(begins), _size(size) {}
+
+        constexpr Iterator begin() const {
+            return Iterator(sequence_iterate<sizeof...(Pools)>(Iterators{}, [&](Iterators r, auto idx){
+                std::get<idx>(r) = std::next(safe_begin(std::get<idx>(_pools)), _begins[idx]);
+                return r;
+            }));
+        }
+
+        constexpr Iterator end() const {
+            return begin() + static_cast<std::ptrdiff_t>(size());
+        }
+
+        constexpr std::size_t size() const {
+            if (_whole) {
+                auto &p = std::get<0>(_pools);
+                return p?static_cast<std::size_t>(p->size()):0;
+            }
+            return _size;
+        }
+
+        ///Retrieve rows of the view as aligned contiguous arrays
+        /**
+         * Available when all pools store values in contiguous array (not for
+         * structure of arrays nor binary components)
+         */
+        constexpr auto columns() const requires(HasColumns<Pools> && ...) {
+            using R = ViewColumns<typename decltype(std::declval<Pools &>()->values())::element_type...>;
+            R r;
+            std::size_t sz = size();
+            sequence_iterate<sizeof...(Pools)>([&](auto idx){
+                auto &p = std::get<idx>(_pools);
+                if (!p) return;
+                if constexpr(idx == 0) r.entities = p->keys().subspan(_begins[idx], sz);
+                std::get<idx>(r.values) = p->values().subspan(_begins[idx], sz);
+            });
+            return r;
+        }
+
+        ///Process the view in parallel
+        /**
+         * @see View::parallel_for_each
+         */
+        template<ViewExecutor Exec, typename Fn>
+        void parallel_for_each(Exec &executor, Fn &&fn, std::size_t chunk_size = 1024) const {
+            auto b = begin();
+            parallel_for_chunks(executor, size(), chunk_size, [&](std::size_t from, std::size_t to){
+                auto e = b + static_cast<std::ptrdiff_t>(to);
+                for (auto iter = b + static_cast<std::ptrdiff_t>(from); iter != e; ++iter) {
+                    invoke_with_row(fn, *iter);
+                }
+            });
+        }
+
+        ///Iterate only rows where a tracked component changed since given tick
+        /**
+         * @param tick minimal tick (see GenericRegistry::current_tick())
+         * @return filtered view, see ChangedView
+         *
+         * At least one component of the view must track changes (see has_change_tracking)
+         */
+        constexpr auto changed_since(ChangeTick tick) const {
+            static_assert((HasChangeTicks<Pools> || ...), "At least one component must track changes");
+            return ChangedView<DenseView>(*this, _pools, tick, false);
+        }
+
+        ///Iterate only rows where a tracked component was added since given tick
+        /** @see changed_since */
+        constexpr auto added_since(ChangeTick tick) const {
+            static_assert((HasChangeTicks<Pools> || ...), "At least one component must track changes");
+            return ChangedView<DenseView>(*this, _pools, tick, true);
+        }
+
+    protected:
+        PoolsTuple _pools = {};
+        Offsets _begins = {};
+        std::size_t _size = 0;
+        bool _whole = false;
+    };
+
     ///A view above multiple pools allows to connect components by using entity
     /**
      * @tparam PoolsTuple a tuple of pointer or pointer-like objects with pools to join. Must be
@@ -71,36 +639,47 @@ namespace ecstl {
         using Values = std::tuple<const Entity &, decltype(std::declval<Pools&>()->begin()->second)...>;
 
 
+        ///Grouped range shared by all pools of the view
+        /** If size is not zero, all pools contain the same sequence of entities
+         * in the range starting at begins[idx] for each pool. This sequence can
+         * be iterated in lockstep without any lookup */
+        struct GroupRange {
+            std::array<std::size_t, sizeof...(Pools)> begins = {};
+            std::size_t size = 0;
+        };
+
         class Sentinel {};
 
         class Iterator {
         public:
 
             using value_type = Values;
-            using reference = const Values &;
-            using pointer = const Values *;
+            using reference = Values;
             using difference_type = std::ptrdiff_t;
             using iterator_category = std::forward_iterator_tag;
             using iterator_concept = std::forward_iterator_tag;
 
             constexpr Iterator() = default;
-            constexpr Iterator(const View *owner, Iterators iters, std::size_t master)
-                :_owner(owner),_iters(std::move(iters)),_master(master) {
+            constexpr Iterator(const View *owner, Iterators iters, std::size_t master, GroupRange group = {}, std::size_t pos = 0)
+                :_owner(owner),_iters(std::move(iters)),_master(master),_group(group),_pos(pos) {
                     post_advance();
                 }            
 
             constexpr Iterator(const Iterator &other)
-                :_owner(other._owner), _iters(other._iters), _master(other._master) {}
+                :_owner(other._owner), _iters(other._iters), _master(other._master)
+                ,_group(other._group), _pos(other._pos) {}
 
             constexpr Iterator(Iterator &&other)
-                :_owner(std::move(other._owner)), _iters(std::move(other._iters)), _master(other._master) {}
+                :_owner(std::move(other._owner)), _iters(std::move(other._iters)), _master(other._master)
+                ,_group(other._group), _pos(other._pos) {}
 
             constexpr Iterator &operator=(const Iterator &other) {
                 if (this != &other) {
                     _owner = other._owner;
                     _iters = other._iters;
                     _master = other._master;
-                    _cache.reset();
+                    _group = other._group;
+                    _pos = other._pos;
                 }
                 return *this;
             }
@@ -110,7 +689,8 @@ namespace ecstl {
                     _owner = std::move(other._owner);
                     _iters = std::move(other._iters);
                     _master = other._master;
-                    _cache.reset();
+                    _group = other._group;
+                    _pos = other._pos;
                 }
                 return *this;
             }
@@ -130,7 +710,8 @@ namespace ecstl {
 
             constexpr Iterator &operator++() {
                 advance();
-                post_advance();
+                //inside of grouped range, all iterators are already at the same entity
+                if (!in_group() || _pos == _group.begins[_master]) post_advance();
                 return *this;
             }
 
@@ -141,27 +722,20 @@ namespace ecstl {
             }
 
             constexpr reference operator*() const {
-                fill_cache();
-                return _cache.value();
+                const Entity &ent = std::get<0>(_iters)->first;
+                return std::apply([&](auto &... iters){return Values(ent,iters->second...);}, _iters);
             }
 
-            constexpr pointer operator->() const {
-                fill_cache();
-                return &_cache.value();
-            }
+            ///Retrieve iterators of all pools
+            constexpr const Iterators &iterators() const {return _iters;}
 
         public:
             const View *_owner = nullptr;
             Iterators _iters = {};
             std::size_t _master = 0;
-            mutable std::optional<Values> _cache;
-
-            constexpr void fill_cache() const {
-                if (_cache.has_value()) return;
-                const Entity &ent = std::get<0>(_iters)->first;
-                _cache.emplace(std::apply([&](auto &... iters){return std::tie(ent,iters->second...);}, _iters));
-            }
-
+            GroupRange _group = {};
+            ///position of master iterator
+            std::size_t _pos = 0;
 
             constexpr std::optional<Entity> get_entity() const {
                 return sequence_iterate<std::tuple_size_v<Iterators> >(std::optional<Entity>(), 
@@ -178,11 +752,37 @@ namespace ecstl {
                 sequence_iterate<std::tuple_size_v<Iterators> >([&](auto idx){
                     ++std::get<idx>(_iters);
                 });
-                _cache.reset();
+                ++_pos;
+            }
+
+            constexpr void advance_master() {
+                sequence_iterate<std::tuple_size_v<Iterators> >([&](auto idx){
+                    if (idx == _master) ++std::get<idx>(_iters);
+                });
+                ++_pos;
+            }
+
+            ///determines whether master iterator is in grouped range
+            constexpr bool in_group() const {
+                return _pos - _group.begins[_master] < _group.size;
+            }
+
+            ///moves all iterators to the entity of master iterator inside of grouped range
+            constexpr void sync_group() {
+                auto ofs = _pos - _group.begins[_master];
+                sequence_iterate<std::tuple_size_v<Iterators> >([&](auto idx){
+                    if (idx == _master) return;
+                    auto &p = std::get<idx>(_owner->_pools);
+                    std::get<idx>(_iters) = std::next(safe_begin(p), _group.begins[idx] + ofs);
+                });
             }
 
             constexpr void post_advance() {
                 while (true) {
+                    if (in_group()) {
+                        sync_group();
+                        break;
+                    }
                     auto r = get_entity();
                     if (!r.has_value()) break;
                     Entity ee = *r;
@@ -197,6 +797,7 @@ namespace ecstl {
                     })) {
                         break;
                     }
+                    advance_master();
                 }
             }
 
@@ -205,6 +806,130 @@ namespace ecstl {
         constexpr View(PoolsTuple pools): _pools(pools){}
 
         constexpr Iterator begin() const {
+            return make_iterator(find_master(), find_group(), 0);
+        }
+
+        constexpr Sentinel end() const {return {};}
+        
+                  // Free function helpers pro ranges machinery
+        friend constexpr Iterator begin(View const &v) noexcept { return v.begin(); }
+        friend constexpr Iterator end(View const &v) noexcept { return v.end(); }
+
+        ///Finds grouped range shared by all pools
+        /**
+         * @return grouped range, size is zero, if pools are not grouped together
+         */
+        constexpr GroupRange find_group() const {
+            GroupRange r;
+            if constexpr(sizeof...(Pools) > 1 && (HasPoolGroup<Pools> && ...)) {
+                std::size_t id = 0;
+                std::size_t size = 0;
+                bool ok = true;
+                sequence_iterate<sizeof...(Pools)>([&](auto idx){
+                    auto &p = std::get<idx>(_pools);
+                    if (!ok || !p) {
+                        ok = false;
+                        return;
+                    }
+                    const auto &g = p->get_group();
+                    if (g.id == 0 || (idx != 0 && (g.id != id || g.size != size))) {
+                        ok = false;
+                        return;
+                    }
+                    id = g.id;
+                    size = g.size;
+                    r.begins[idx] = g.begin;
+                });
+                if (ok) r.size = size;
+            }
+            return r;
+        }
+
+        ///Process the view in parallel
+        /**
+         * Splits the dense range of the master pool (the smallest pool) into chunks. The
+         * chunks are processed by tasks dispatched to the executor. The calling thread
+         * processes chunks as well, so the function completes even if the executor
+         * doesn't run the tasks (for example AsyncSignalDispatcher<0> without pumping).
+         * The function returns after all chunks are processed.
+         *
+         * @param executor an object with dispatch() function, for example AsyncSignalDispatcher.
+         * If the executor declares thread_count, no more tasks than threads are dispatched
+         * @param fn function called for each row of the view. It can accept the row as
+         * the tuple (same as the iterator returns), or as separate arguments (entity, components...)
+         * @param chunk_size count of positions of the master pool in one chunk
+         *
+         * Guarantees: every row is passed to exactly one invocation of the function. Invocations
+         * run concurrently, so the function can freely write to the components passed to it
+         * (components of the current entity), but must not write to components of other entities.
+         * Reading other entities is only safe for components which are not written by any invocation.
+         * The registry and the pools must not be modified during the call (no emplace, set,
+         * remove, destroy_entity, group_entities...)
+         *
+         * @note tasks are noexcept, exception thrown from the function terminates the program
+         */
+        template<ViewExecutor Exec, typename Fn>
+        void parallel_for_each(Exec &executor, Fn &&fn, std::size_t chunk_size = 1024) const {
+            if (auto d = dense()) {
+                d->parallel_for_each(executor, fn, chunk_size);
+                return;
+            }
+            std::size_t master = find_master();
+            std::size_t total = sequence_iterate<sizeof...(Pools)>(std::size_t(0), [&](std::size_t r, auto idx){
+                if (idx != master) return r;
+                auto &p = std::get<idx>(_pools);
+                return p?static_cast<std::size_t>(p->size()):std::size_t(0);
+            });
+            GroupRange group = find_group();
+            parallel_for_chunks(executor, total, chunk_size, [&](std::size_t from, std::size_t to){
+                for (auto iter = make_iterator(master, group, from); !(iter == Sentinel()) && iter._pos < to; ++iter) {
+                    invoke_with_row(fn, *iter);
+                }
+            });
+        }
+
+        ///Returns dense view if the pools are fully grouped
+        /**
+         * Pools are fully grouped, when the grouped range covers the smallest pool. In this
+         * case, the grouped range contains all rows of this view.
+         * @return dense view (sized random access range) or nullopt, if pools are not fully grouped
+         */
+        constexpr std::optional<DenseView<PoolsTuple> > dense() const {
+            GroupRange g = find_group();
+            if (g.size == 0) return std::nullopt;
+            std::size_t smallest = std::numeric_limits<std::size_t>::max();
+            sequence_iterate<sizeof...(Pools)>([&](auto idx){
+                smallest = std::min<std::size_t>(smallest, std::get<idx>(_pools)->size());
+            });
+            if (smallest != g.size) return std::nullopt;
+            return DenseView<PoolsTuple>(_pools, g.begins, g.size);
+        }
+
+        ///Iterate only rows where a tracked component changed since given tick
+        /**
+         * @param tick minimal tick (see GenericRegistry::current_tick())
+         * @return filtered view, see ChangedView
+         *
+         * At least one component of the view must track changes (see has_change_tracking)
+         */
+        constexpr auto changed_since(ChangeTick tick) const {
+            static_assert((HasChangeTicks<Pools> || ...), "At least one component must track changes");
+            return ChangedView<View>(*this, _pools, tick, false);
+        }
+
+        ///Iterate only rows where a tracked component was added since given tick
+        /** @see changed_since */
+        constexpr auto added_since(ChangeTick tick) const {
+            static_assert((HasChangeTicks<Pools> || ...), "At least one component must track changes");
+            return ChangedView<View>(*this, _pools, tick, true);
+        }
+
+
+    private:
+        PoolsTuple _pools;
+
+        ///finds index of the smallest pool, which is used to drive the iteration
+        constexpr std::size_t find_master() const {
             std::size_t volume = std::numeric_limits<std::size_t>::max();
             std::size_t best = 0;
             sequence_iterate<std::tuple_size_v<PoolsTuple> >([&](auto idx){
@@ -213,24 +938,35 @@ namespace ecstl {
                 if (sz < volume) {
                     best = idx;
                     volume = sz;
-                }                
-            });            
-            return Iterator(this, std::apply([&](auto & ... ps) {
-                return std::make_tuple(safe_begin(ps)...);
-            }, _pools), best);
+                }
+            });
+            return best;
         }
 
-        constexpr Sentinel end() const {return {};}
+        ///creates iterator with master iterator at given position of the master pool
+        constexpr Iterator make_iterator(std::size_t master, const GroupRange &group, std::size_t pos) const {
+            Iterators iters = std::apply([&](auto & ... ps) {
+                return std::make_tuple(safe_begin(ps)...);
+            }, _pools);
+            if (pos) sequence_iterate<sizeof...(Pools)>([&](auto idx){
+                if (idx == master) std::get<idx>(iters) = std::next(std::get<idx>(iters), pos);
+            });
+            return Iterator(this, std::move(iters), master, group, pos);
+        }
         
-                  // Free function helpers pro ranges machinery
-        friend constexpr Iterator begin(View const &v) noexcept { return v.begin(); }
-        friend constexpr Iterator end(View const &v) noexcept { return v.end(); }
+    };
 
-        
+    ///View above single pool is dense view over whole pool (sized random access range)
+    template<IsPointerLike Pool>
+    class View<std::tuple<Pool> >: public DenseView<std::tuple<Pool> > {
+    public:
+        using Super = DenseView<std::tuple<Pool> >;
+        using PoolsTuple = std::tuple<Pool>;
 
+        constexpr View() = default;
+        constexpr View(PoolsTuple pools):Super(std::move(pools)) {}
 
-    private:
-        PoolsTuple _pools;
-        
+        ///Single pool view is always dense
+        constexpr std::optional<Super> dense() const {return *this;}
     };
 }
\ No newline at end of file
@@ -132,6 +132,20 @@ namespace ecstl {
         return true;
     }
 
+    constexpr void erase_at(std::span<const std::size_t> positions) {
+        for (std::size_t pos: positions) {
+            _index.erase(_keys[pos]);
+            if (_deleter) _deleter(_values.data()+pos*_component_size, _component_size);
+        }
+        auto new_size = fill_holes_from_back(positions, _keys.size(), [&](std::size_t from, std::size_t to){
+            _keys[to] = std::move(_keys[from]);
+            std::copy_n(_values.data()+from*_component_size, _component_size, _values.data()+to*_component_size);
+            _index.find(_keys[to])->second = to;
+        });
+        _keys.erase(_keys.begin() + new_size, _keys.end());
+        _values.resize(new_size*_component_size);
+    }
+
     constexpr iterator erase(iterator it) {
         erase(it->first);
         return it;
@@ -179,6 +193,15 @@ namespace ecstl {
         _keys.clear();
     }
 
+    constexpr void swap_items(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        std::swap(_keys[a], _keys[b]);
+        std::swap_ranges(_values.data()+a*_component_size, _values.data()+(a+1)*_component_size,
+                         _values.data()+b*_component_size);
+        _index.find(_keys[a])->second = a;
+        _index.find(_keys[b])->second = b;
+    }
+
     protected:
         std::size_t _component_size = 0;
         OpenHashMap<K, std::size_t, Hasher, Equal> _index;
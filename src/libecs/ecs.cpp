@@ -28,12 +28,12 @@ ecs_entity_t ecs_create_named_entity(ecs_registry_t * reg, const char *name)
 
 void ecs_destroy_entity(ecs_registry_t * reg, ecs_entity_t e)
 {
-    cast_from_c(reg)->destroy_entity(Entity(e));
+    cast_from_c(reg)->destroy_entity(Entity::from_id(e));
 }
 
 size_t ecs_get_entity_name(ecs_registry_t * reg, ecs_entity_t e, char *buf, size_t bufsize)
 {
-    auto str = cast_from_c(reg)->get_entity_name(e);
+    auto str = cast_from_c(reg)->get_entity_name(Entity::from_id(e));
     if (buf == nullptr) return str.size()+1;
     if (bufsize == 0) return 0;    
     str = str.substr(0, bufsize-1);
@@ -67,7 +67,7 @@ int ecs_store(ecs_registry_t * reg, ecs_entity_t entity, ecs_component_t compone
     auto pool = r->get_component_pool<BinaryComponentView>(ComponentTypeID(component));
     if (!pool) pool  = r->create_component_pool<BinaryComponentView>(ComponentTypeID(component));
     auto val =  ConstBinaryComponentView(reinterpret_cast<const char *>(data),size);
-    auto ins = pool->try_emplace(Entity(entity),val);
+    auto ins = pool->try_emplace(Entity::from_id(entity),val);
     if (!ins.second) {
         if (ins.first == pool->end()) return -1;
         auto del = pool->get_deleter();
@@ -79,7 +79,7 @@ int ecs_store(ecs_registry_t * reg, ecs_entity_t entity, ecs_component_t compone
 
 const void *ecs_retrieve(const ecs_registry_t * reg, ecs_entity_t entity, ecs_component_t component)
 {
-    auto r = cast_from_c(reg)->get<BinaryComponentView>(Entity(entity),ComponentTypeID(component));
+    auto r = cast_from_c(reg)->get<BinaryComponentView>(Entity::from_id(entity),ComponentTypeID(component));
     if (r.has_value()) {
         auto rr = r.value();
         return rr.data();
@@ -90,7 +90,7 @@ const void *ecs_retrieve(const ecs_registry_t * reg, ecs_entity_t entity, ecs_co
 
 void *ecs_retrieve_mut(ecs_registry_t *reg, ecs_entity_t entity, ecs_component_t component)
 {
-    auto r = cast_from_c(reg)->get<BinaryComponentView>(Entity(entity),ComponentTypeID(component));
+    auto r = cast_from_c(reg)->get<BinaryComponentView>(Entity::from_id(entity),ComponentTypeID(component));
     if (r.has_value()) {
         auto rr = r.value();
         return rr.data();
@@ -101,7 +101,7 @@ void *ecs_retrieve_mut(ecs_registry_t *reg, ecs_entity_t entity, ecs_component_t
 
 void ecs_remove(ecs_registry_t *reg, ecs_entity_t entity, ecs_component_t component)
 {
-    cast_from_c(reg)->remove<BinaryComponentView>(Entity(entity), ComponentTypeID(component));
+    cast_from_c(reg)->remove<BinaryComponentView>(Entity::from_id(entity), ComponentTypeID(component));
 }
 
 
@@ -195,7 +195,7 @@ static int make_group_impl(Registry *reg, const ecs_component_t *components, std
 
 int ecs_has(const ecs_registry_t *reg, ecs_entity_t entity, int component_count, const ecs_component_t *components) {
     auto r = cast_from_c(reg);
-    Entity e(entity);
+    Entity e = Entity::from_id(entity);
     for (int i = 0; i < component_count; ++i) {
         if (!r->has<BinaryComponentView>(e, {ComponentTypeID(components[i])})) return 0;
     }
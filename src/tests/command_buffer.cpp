@@ -0,0 +1,170 @@
+#include "../ecstl/ecstl.hpp"
+#include "../ecstl/signals_async.hpp"
+#include "check.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace ecstl;
+
+struct Health {
+    int hp = 0;
+};
+
+struct Label {
+    std::string text;
+};
+
+struct Big {
+    char data[10000];
+    int v;
+};
+
+int test_deferred_during_iteration() {
+    Registry db;
+    std::vector<Entity> ents;
+    for (int i = 0; i < 100; ++i) {
+        auto e = db.create_entity();
+        db.set<Health>(e, {i});
+        ents.push_back(e);
+    }
+    Registry::CommandBuffer cmd;
+    for (auto [e, h]: db.view<Health>()) {
+        if (h.hp % 2) cmd.destroy_entity(e);
+        else cmd.set<Label>(e, {std::to_string(h.hp)});
+    }
+    auto spawned = cmd.create_entity("spawned");
+    cmd.set<Health>(spawned, {1000});
+    CHECK_EQUAL(cmd.size(), 102U);
+    db.apply(std::move(cmd));
+    CHECK(cmd.empty());
+    CHECK_EQUAL(db.all_of<Health>().size(), 51U);
+    CHECK_EQUAL(db.all_of<Label>().size(), 50U);
+    CHECK_EQUAL(db.get<Label>(ents[10])->text, std::string("10"));
+    CHECK(!db.is_known(ents[11]));
+    CHECK_EQUAL(db.get_entity_name(spawned), std::string_view("spawned"));
+    CHECK_EQUAL(db.get<Health>(spawned)->hp, 1000);
+    return 0;
+}
+
+int test_order() {
+    Registry db;
+    auto e = db.create_entity();
+    Registry::CommandBuffer cmd;
+    cmd.set<Health>(e, {1});
+    cmd.set<Label>(e, {"a"});
+    cmd.set<Health>(e, {2});
+    cmd.remove<Label>(e);
+    cmd.set<Health>(e, ComponentTypeID(1), {3});
+    cmd.emplace<Big>(e, {}, Big{{}, 42});
+    db.apply(std::move(cmd));
+    CHECK_EQUAL(db.get<Health>(e)->hp, 2);
+    CHECK_EQUAL(db.get<Health>(e, ComponentTypeID(1))->hp, 3);
+    CHECK(!db.has<Label>(e));
+    CHECK_EQUAL(db.get<Big>(e)->v, 42);
+
+    //destroy is a barrier
+    cmd.set<Health>(e, {5});
+    cmd.destroy_entity(e);
+    cmd.set<Label>(e, {"after"});
+    db.apply(std::move(cmd));
+    CHECK(!db.has<Health>(e));
+    CHECK_EQUAL(db.get<Label>(e)->text, std::string("after"));
+    return 0;
+}
+
+int test_discard() {
+    Registry::CommandBuffer cmd;
+    auto e = cmd.create_entity("never applied");
+    cmd.set<Label>(e, {std::string(100, 'x')});
+    CHECK_EQUAL(cmd.size(), 2U);
+    cmd.clear();
+    CHECK(cmd.empty());
+    cmd.set<Label>(e, {"dropped by destructor"});
+    return 0;
+}
+
+int test_merge_parallel() {
+    Registry db;
+    for (int i = 0; i < 4000; ++i) db.set<Health>(db.create_entity(), {i});
+    auto disp = AsyncSignalDispatcher<4>::create();
+    constexpr std::size_t chunk = 500;
+    std::vector<Registry::CommandBuffer> buffers(8);
+    auto b = db.view<Health>().begin();
+    parallel_for_chunks(disp, 4000, chunk, [&](std::size_t from, std::size_t to){
+        auto &buf = buffers[from / chunk];
+        for (auto iter = b + static_cast<std::ptrdiff_t>(from); iter != b + static_cast<std::ptrdiff_t>(to); ++iter) {
+            auto [e, h] = *iter;
+            if (h.hp % 4 == 0) buf.set<Label>(e, {"x"});
+        }
+    });
+    Registry::CommandBuffer all;
+    for (auto &buf: buffers) all.merge(std::move(buf));
+    CHECK_EQUAL(all.size(), 1000U);
+    db.apply(std::move(all));
+    CHECK_EQUAL(db.all_of<Label>().size(), 1000U);
+    return 0;
+}
+
+int test_merge_into_empty() {
+    Registry db;
+    auto e1 = db.create_entity();
+    auto e2 = db.create_entity();
+    Registry::CommandBuffer task;
+    task.set<Health>(e1, {111});
+    Registry::CommandBuffer main;
+    main.merge(std::move(task));
+    //must not reuse block of merged buffer
+    main.set<Health>(e2, {222});
+    db.apply(std::move(main));
+    CHECK_EQUAL(db.get<Health>(e1)->hp, 111);
+    CHECK_EQUAL(db.get<Health>(e2)->hp, 222);
+    return 0;
+}
+
+int test_large_first_payload() {
+    Registry db;
+    auto e1 = db.create_entity();
+    auto e2 = db.create_entity();
+    Registry::CommandBuffer cmd;
+    Big big;
+    std::fill(std::begin(big.data), std::end(big.data), 'x');
+    big.v = 7;
+    cmd.set<Big>(e1, big);
+    cmd.set<Label>(e2, {std::string(64, 'M')});
+    cmd.set<Health>(e2, {3});
+    db.apply(std::move(cmd));
+    auto b = db.get<Big>(e1);
+    CHECK(std::all_of(std::begin(b->data), std::end(b->data), [](char c){return c == 'x';}));
+    CHECK_EQUAL(b->v, 7);
+    CHECK_EQUAL(db.get<Label>(e2)->text, std::string(64, 'M'));
+    CHECK_EQUAL(db.get<Health>(e2)->hp, 3);
+    return 0;
+}
+
+struct Counted {
+    int *drops;
+    void drop() {++*drops;}
+};
+
+int test_stale_entity() {
+    RegistryRecycling db;
+    auto e = db.create_entity();
+    db.destroy_entity(e);
+    auto e2 = db.create_entity();
+    int drops = 0;
+    RegistryRecycling::CommandBuffer cmd;
+    cmd.set<Counted>(e, {&drops});
+    cmd.set<Counted>(e2, {&drops});
+    db.apply(std::move(cmd));
+    //payload of stale entity is not stored and it is dropped
+    CHECK_EQUAL(drops, 1);
+    CHECK(!db.has<Counted>(e));
+    CHECK(db.has<Counted>(e2));
+    return 0;
+}
+
+int main() {
+    return test_deferred_during_iteration() + test_order() + test_discard() + test_merge_parallel()
+        + test_merge_into_empty() + test_large_first_payload() + test_stale_entity();
+}
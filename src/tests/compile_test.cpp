@@ -13,8 +13,9 @@ struct TestComponent {
 constexpr auto example_component = ecstl::ComponentTypeID("example_component");
 
 
+template<ecstl::OpenHashProbing probing>
 void testOpenHash() {
-    ecstl::OpenHashMap<int, int> hh;
+    ecstl::OpenHashMap<int, int, std::hash<int>, std::equal_to<int>, probing> hh;
     for (int i = 0; i < 100; ++i) {
         hh.emplace(i, i*2+1);
     }
@@ -54,8 +55,36 @@ void testOpenHash() {
 
 }
 
+struct SameHash {
+    std::size_t operator()(int x) const {return static_cast<std::size_t>(x / 512);}
+};
+
+template<ecstl::OpenHashProbing probing>
+void testOpenHashSameHash() {
+    //probe distances exceed what fits to the state byte of robin hood probing
+    ecstl::OpenHashMap<int, int, SameHash, std::equal_to<int>, probing> hh;
+    for (int i = 0; i < 300; ++i) hh.emplace(i, i);
+    for (int i = 1000; i < 1100; ++i) hh.emplace(i, i);
+    if (hh.size() != 400) abort();
+    for (int i = 0; i < 300; i += 2) hh.erase(i);
+    for (int i = 0; i < 300; ++i) {
+        auto iter = hh.find(i);
+        if ((i % 2 == 0) != (iter == hh.end())) abort();
+        if (i % 2 && iter->second != i) abort();
+    }
+    for (int i = 1000; i < 1100; ++i) {
+        if (hh.find(i) == hh.end()) abort();
+    }
+    if (hh.find(301) != hh.end() || hh.find(5000) != hh.end()) abort();
+}
+
 int main() {
-    testOpenHash();
+    testOpenHash<ecstl::OpenHashProbing::linear>();
+    testOpenHash<ecstl::OpenHashProbing::swiss>();
+    testOpenHash<ecstl::OpenHashProbing::robin_hood>();
+    testOpenHashSameHash<ecstl::OpenHashProbing::linear>();
+    testOpenHashSameHash<ecstl::OpenHashProbing::swiss>();
+    testOpenHashSameHash<ecstl::OpenHashProbing::robin_hood>();
 
     ecstl::RegistrySharedPtr db;
     auto aaa = db.create_entity("aaa");
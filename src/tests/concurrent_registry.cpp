@@ -0,0 +1,123 @@
+#include "../ecstl/ecstl.hpp"
+#include "../ecstl/registry_concurrent.hpp"
+#include "check.h"
+#include <thread>
+#include <vector>
+
+using namespace ecstl;
+
+struct Position {
+    int x = 0;
+};
+
+struct Velocity {
+    int v = 0;
+};
+
+static RegistryConcurrent prepare(std::vector<Entity> &ents, int count) {
+    RegistryConcurrent db;
+    db.create_component_pool<Position>();
+    db.create_component_pool<Velocity>();
+    for (int i = 0; i < count; ++i) {
+        auto e = db.create_entity();
+        db.set<Position>(e, {i});
+        db.set<Velocity>(e, {1});
+        ents.push_back(e);
+    }
+    return db;
+}
+
+int test_disjoint_writers() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 1000);
+    //two threads write different types, two threads read
+    std::thread pos_writer([&]{
+        for (int r = 0; r < 10; ++r) for (auto e: ents) {
+            auto p = db.get<Position>(e);
+            p->x += 1;
+        }
+    });
+    std::thread vel_writer([&]{
+        for (int r = 0; r < 10; ++r) for (auto e: ents) {
+            db.set<Velocity>(e, {r});
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) readers.emplace_back([&]{
+        for (int r = 0; r < 10; ++r) for (auto e: ents) {
+            auto p = db.get<const Position>(e);
+            auto v = db.get<const Velocity>(e);
+            if (!p || !v || !p.owns_lock()) abort();
+        }
+    });
+    pos_writer.join();
+    vel_writer.join();
+    for (auto &t: readers) t.join();
+    CHECK_EQUAL(db.get<const Position>(ents[5])->x, 15);
+    CHECK_EQUAL(db.get<const Velocity>(ents[5])->v, 9);
+    return 0;
+}
+
+int test_locked_view() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 500);
+    auto worker = [&]{
+        for (int r = 0; r < 20; ++r) {
+            auto lk = db.lock<Position, const Velocity>();
+            for (auto [e, p, v]: db.view<Position, const Velocity>()) p.x += v.v;
+        }
+    };
+    //other thread locks the same pools in different order
+    auto worker2 = [&]{
+        for (int r = 0; r < 20; ++r) {
+            auto lk = db.lock<const Velocity, Position>();
+            for (auto [e, v, p]: db.view<const Velocity, Position>()) p.x -= v.v;
+        }
+    };
+    std::thread a(worker), b(worker2), c(worker);
+    a.join();
+    b.join();
+    c.join();
+    CHECK_EQUAL(db.get<const Position>(ents[7])->x, 27);
+    return 0;
+}
+
+int test_destroy_and_remove() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 100);
+    std::thread a([&]{for (int i = 0; i < 50; ++i) db.destroy_entity(ents[i]);});
+    std::thread b([&]{for (int i = 50; i < 100; ++i) db.remove<Velocity>(ents[i]);});
+    a.join();
+    b.join();
+    CHECK_EQUAL(db.all_of<Position>().size(), 50U);
+    CHECK_EQUAL(db.all_of<Velocity>().size(), 0U);
+    return 0;
+}
+
+int test_bulk_with_readers() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 100);
+    //bulk insert grows the pool while readers hold refs to it
+    std::thread writer([&]{
+        for (int r = 0; r < 50; ++r) {
+            std::vector<Entity> batch;
+            for (int i = 0; i < 100; ++i) batch.push_back(db.create_entity());
+            db.emplace_bulk<Position>(batch, std::vector<Position>(batch.size(), Position{-1}));
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) readers.emplace_back([&]{
+        for (int r = 0; r < 50; ++r) for (int i = 0; i < 100; ++i) {
+            auto p = db.get<const Position>(ents[i]);
+            if (!p || p->x != i) abort();
+        }
+    });
+    writer.join();
+    for (auto &t: readers) t.join();
+    CHECK_EQUAL(db.all_of<Position>().size(), 5100U);
+    return 0;
+}
+
+int main() {
+    return test_disjoint_writers() + test_locked_view() + test_destroy_and_remove() + test_bulk_with_readers();
+}
@@ -1,4 +1,6 @@
 #include "../ecstl/ecstl.hpp"
+#include "../ecstl/registry_sparse.hpp"
+#include "../ecstl/archetype_registry.hpp"
 
 using namespace ecstl;
 
@@ -7,8 +9,9 @@ struct PrimHash {
 };
 
 
+template<OpenHashProbing probing>
 constexpr int test_open_hash() {
-    ecstl::OpenHashMap<int, unique_ptr<int>, PrimHash> hh;
+    ecstl::OpenHashMap<int, unique_ptr<int>, PrimHash, std::equal_to<int>, probing> hh;
     for (int i = 0; i < 100; ++i) {
         hh.emplace(i, make_unique<int>(i*2+1));
     }
@@ -48,7 +51,43 @@ constexpr int test_open_hash() {
     return 0;
 }
 
-static_assert(test_open_hash() == 0, "Failed");;
+static_assert(test_open_hash<OpenHashProbing::linear>() == 0, "Failed");
+static_assert(test_open_hash<OpenHashProbing::swiss>() == 0, "Failed");
+static_assert(test_open_hash<OpenHashProbing::robin_hood>() == 0, "Failed");
+
+struct CollidingHash {
+    constexpr std::size_t operator()(int x) const {return static_cast<std::size_t>(x / 8);}
+};
+
+template<OpenHashProbing probing>
+constexpr int test_open_hash_erase_chains() {
+    //long probe chains, erase must shift items back without breaking them
+    ecstl::OpenHashMap<int, int, CollidingHash, std::equal_to<int>, probing> hh;
+    for (int i = 0; i < 64; ++i) hh.emplace(i, i);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = round; i < 64; i += 3) hh.erase(i);
+        for (int i = 0; i < 64; ++i) {
+            bool erased = i % 3 <= round;
+            auto iter = hh.find(i);
+            if (erased != (iter == hh.end())) return 1;
+            if (!erased && iter->second != i) return 2;
+        }
+    }
+    if (hh.size() != 0) return 3;
+    for (int i = 0; i < 40; ++i) hh.emplace(i, i);
+    //erase through iterator visits every item once
+    int cnt = 0;
+    for (auto iter = hh.begin(); iter != hh.end();) {
+        iter = hh.erase(iter);
+        ++cnt;
+    }
+    if (cnt != 40 || hh.size() != 0 || hh.begin() != hh.end()) return 4;
+    return 0;
+}
+
+static_assert(test_open_hash_erase_chains<OpenHashProbing::linear>() == 0);
+static_assert(test_open_hash_erase_chains<OpenHashProbing::swiss>() == 0);
+static_assert(test_open_hash_erase_chains<OpenHashProbing::robin_hood>() == 0);
 
 constexpr bool create_entity() {
     auto e1 = Entity::create_consteval();
@@ -179,3 +218,520 @@ constexpr bool empty_view_test()  {
 
 static_assert(empty_view_test());
 
+
+constexpr int tracked_registry_test() {
+    using TrackedRegistry = GenericRegistry<TrackedRegistryTraits>;
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+
+    TrackedRegistry rg;
+    rg.set_entity_name(aaa, "aaa");
+    rg.set_entity_name(bbb, "bbb");
+    rg.set<TestComponent>(aaa, {1});
+    rg.set<TestComponent>(bbb, {2});
+    rg.set<DropTestComponent>(bbb, {new int(3)});
+
+    if (!rg.is_known(bbb)) return 1;
+    rg.destroy_entity(bbb);
+    if (rg.is_known(bbb)) return 2;
+    if (rg.has<TestComponent>(bbb)) return 3;
+    if (!rg.has<TestComponent>(aaa)) return 4;
+
+    rg.remove<TestComponent>(aaa);
+    if (!rg.is_known(aaa)) return 5;
+    rg.remove_all_of<EntityName>();
+    if (rg.is_known(aaa)) return 6;
+    return 0;
+}
+
+static_assert(tracked_registry_test() == 0);
+
+constexpr int test_sparse_set() {
+    ecstl::SparseSetFlatMap<int, unique_ptr<int>, PrimHash> mp;
+    for (int i = 0; i < 3000; ++i) {
+        mp.emplace(i, make_unique<int>(i*2+1));
+    }
+    for (int i = 0; i < 3000; i+=2) {
+        mp.erase(i);
+    }
+    if (mp.size() != 1500) return 1;
+    for (int i = 0; i < 3000;  ++i) {
+        auto iter = mp.find(i);
+        if (i & 1) {
+            if (iter == mp.end()) return 2;
+            if (*iter->second != i *2 + 1) return 3;
+        } else {
+            if (iter != mp.end()) return 4;
+        }
+    }
+    for (const auto &[k, v]: mp) {
+        if (*v != k * 2 + 1) return 5;
+    }
+    return 0;
+}
+
+static_assert(test_sparse_set() == 0);
+
+constexpr int sparse_set_registry_test() {
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(5000, Entity::is_const_eval{});
+
+    RegistrySparseSet rg;
+    rg.set_entity_name(aaa, "aaa");
+    rg.set_entity_name(bbb, "bbb");
+    rg.set_entity_name(ccc, "ccc");
+    rg.set<TestComponent>(ccc,{55});
+    rg.set<TestComponent>(bbb,{42});
+    rg.remove<TestComponent>(bbb);
+
+    int cnt = 0;
+    for (auto [e, n, t]: rg.view<EntityName, TestComponent>()) {
+        if (e != ccc || static_cast<std::string_view>(n) != "ccc" || t.foo != 55) return 1;
+        ++cnt;
+    }
+    if (cnt != 1) return 2;
+    rg.destroy_entity(ccc);
+    if (rg.get_entity_name(aaa) != "aaa") return 3;
+    if (rg.has<EntityName>(ccc)) return 4;
+    return 0;
+}
+
+static_assert(sparse_set_registry_test() == 0);
+
+constexpr int grouped_view_test() {
+    Registry rg = prepare_test_registry();
+    auto eee = Entity(5, Entity::is_const_eval{});
+    //entity without a name is skipped by the view
+    rg.set<TestComponent>(eee, {77});
+
+    auto sum_view = [&]{
+        int sum = 0;
+        for (auto [e, t, n]: rg.view<TestComponent, EntityName>()) {
+            sum += t.foo;
+        }
+        return sum;
+    };
+
+    if (sum_view() != 97) return 1;
+    if (rg.view<TestComponent, EntityName>().find_group().size != 0) return 2;
+    rg.group<EntityName, TestComponent>();
+    if (rg.view<TestComponent, EntityName>().find_group().size != 2) return 3;
+    if (sum_view() != 97) return 4;
+    rg.remove<TestComponent>(Entity(4, Entity::is_const_eval{}));
+    if (rg.view<TestComponent, EntityName>().find_group().size != 0) return 5;
+    if (sum_view() != 42) return 6;
+    return 0;
+}
+
+static_assert(grouped_view_test() == 0);
+
+constexpr int owning_group_test() {
+    Registry rg = prepare_test_registry();
+    if (!rg.create_owning_group<TestComponent, EntityName>()) return 1;
+    if (rg.group<EntityName, TestComponent>()) return 2;
+    if (rg.view<EntityName, TestComponent>().find_group().size != 2) return 3;
+
+    auto eee = Entity(5, Entity::is_const_eval{});
+    rg.set<TestComponent>(eee, {77});
+    if (rg.view<EntityName, TestComponent>().find_group().size != 2) return 4;
+    rg.set_entity_name(eee, "eee");
+    if (rg.view<EntityName, TestComponent>().find_group().size != 3) return 5;
+    rg.destroy_entity(Entity(2, Entity::is_const_eval{}));
+    if (rg.view<EntityName, TestComponent>().find_group().size != 2) return 6;
+
+    int sum = 0;
+    for (auto [e, n, t]: rg.view<EntityName, TestComponent>()) {
+        sum += t.foo;
+    }
+    if (sum != 132) return 7;
+    rg.remove_all_of<TestComponent>();
+    if (rg.view<EntityName, TestComponent>().find_group().size != 0) return 8;
+    return 0;
+}
+
+static_assert(owning_group_test() == 0);
+
+using SinglePoolView = decltype(std::declval<Registry &>().view<TestComponent>());
+static_assert(std::ranges::random_access_range<SinglePoolView>);
+static_assert(std::ranges::sized_range<SinglePoolView>);
+static_assert(std::ranges::random_access_range<decltype(std::declval<Registry &>().view<TestComponent, EntityName>().dense())::value_type>);
+static_assert(std::ranges::random_access_range<decltype(std::declval<Registry &>().all_of<TestComponent>())>);
+
+constexpr int dense_view_test() {
+    Registry rg = prepare_test_registry();
+    auto v = rg.view<TestComponent>();
+    if (v.size() != 2) return 1;
+    if (std::get<0>(v[1]) != std::get<0>(*(v.begin() + 1)) || v.end() - v.begin() != 2) return 2;
+    int sum = 0;
+    for (auto [e, t]: v | std::views::reverse) sum = sum * 100 + t.foo;
+    if (sum != 5542 && sum != 4255) return 3;
+
+    if (rg.view<TestComponent, EntityName>().dense()) return 4;
+    rg.group<EntityName, TestComponent>();
+    auto d = rg.view<TestComponent, EntityName>().dense();
+    if (!d || d->size() != 2) return 5;
+    sum = 0;
+    for (std::size_t i = 0; i < d->size(); ++i) {
+        auto [e, t, n] = (*d)[static_cast<std::ptrdiff_t>(i)];
+        if (!rg.has<TestComponent>(e) || static_cast<std::string_view>(n) != rg.get_entity_name(e)) return 6;
+        sum += t.foo;
+    }
+    if (sum != 97) return 7;
+    //new entity outside of grouped range - not fully grouped
+    auto eee = Entity(5, Entity::is_const_eval{});
+    rg.set<TestComponent>(eee, {77});
+    rg.set_entity_name(eee, "eee");
+    if (rg.view<TestComponent, EntityName>().dense()) return 8;
+    return 0;
+}
+
+static_assert(dense_view_test() == 0);
+
+struct SoaPosition {
+    static constexpr ComponentLayout component_layout = ComponentLayout::soa;
+    int x;
+    int y;
+    double w;
+};
+
+static_assert(aggregate_arity<SoaPosition> == 3);
+static_assert(std::is_same_v<Registry::PoolType<SoaPosition>,
+                GenericComponentPool<SoaPosition, DefaultRegistryTraits::SoaPoolStorage> >);
+
+constexpr int soa_pool_test() {
+    Registry rg = prepare_test_registry();
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(3, Entity::is_const_eval{});
+    rg.set<SoaPosition>(aaa, {1, 2, 0.5});
+    rg.set<SoaPosition>(bbb, {10, 20, 1.5});
+    rg.emplace<SoaPosition>(ccc, 100, 200, 2.5);
+    //replaces existing component
+    if (rg.set<SoaPosition>(ccc, {101, 201, 2.5})) return 1;
+
+    for (auto [e, p, t]: rg.view<SoaPosition, TestComponent>()) {
+        auto [x, y, w] = p;
+        x += t.foo;
+        y = x * 2;
+    }
+    auto p = rg.get<SoaPosition>(bbb);
+    if (!p || p->get<0>() != 52 || p->get<1>() != 104) return 2;
+    SoaPosition copy = *rg.get<const SoaPosition>(aaa);
+    if (copy.x != 1 || copy.y != 2 || copy.w != 0.5) return 3;
+
+    auto &pool = *rg.get_component_pool<SoaPosition>();
+    int sum = 0;
+    for (int x: pool.column<0>()) sum += x;
+    if (sum != 1 + 52 + 101) return 4;
+
+    rg.remove<SoaPosition>(aaa);
+    if (rg.has<SoaPosition>(aaa) || !rg.has<SoaPosition>(ccc)) return 5;
+    if (rg.get<SoaPosition>(ccc)->get<0>() != 101) return 6;
+    rg.group<SoaPosition, TestComponent>();
+    if (rg.view<SoaPosition, TestComponent>().find_group().size != 1) return 7;
+    rg.destroy_entity(ccc);
+    if (rg.is_known(ccc) || rg.all_of<SoaPosition>().size() != 1) return 8;
+    return 0;
+}
+
+static_assert(soa_pool_test() == 0);
+
+constexpr int columns_test() {
+    Registry rg = prepare_test_registry();
+    auto single = rg.columns<const TestComponent>();
+    if (!single || single->size() != 2) return 1;
+    int sum = 0;
+    for (const TestComponent &t: single->get<0>()) sum += t.foo;
+    if (sum != 97) return 2;
+
+    if (rg.columns<TestComponent, EntityName>()) return 3;
+    rg.group<EntityName, TestComponent>();
+    auto cols = rg.columns<TestComponent, EntityName>();
+    if (!cols || cols->size() != 2) return 4;
+    for (std::size_t i = 0; i < cols->size(); ++i) {
+        Entity e = cols->entities[i];
+        if (rg.get<TestComponent>(e)->foo != cols->get<0>()[i].foo) return 5;
+        if (rg.get_entity_name(e) != static_cast<std::string_view>(cols->get<1>()[i])) return 6;
+        cols->get<0>()[i].foo += 1;
+    }
+    if (rg.get<TestComponent>(Entity(2, Entity::is_const_eval{}))->foo != 43) return 7;
+    if (rg.columns<NotRegisteredComponent>()->size() != 0) return 8;
+    return 0;
+}
+
+static_assert(columns_test() == 0);
+
+static_assert(std::ranges::random_access_range<EntityRange>);
+static_assert(std::ranges::sized_range<EntityRange>);
+
+constexpr int emplace_bulk_test() {
+    Registry rg = prepare_test_registry();
+    EntityRange ents(100, 50);
+    if (ents.size() != 50 || ents[49] != Entity(149, Entity::is_const_eval{})) return 1;
+    std::vector<TestComponent> vals;
+    for (int i = 0; i < 50; ++i) vals.push_back({i});
+    if (rg.emplace_bulk<TestComponent>(ents, vals) != 50) return 2;
+    if (rg.all_of<TestComponent>().size() != 52) return 3;
+    if (rg.get<TestComponent>(ents[10])->foo != 10) return 4;
+    //existing components are replaced, shorter range of values stops the loop
+    vals.resize(10);
+    for (auto &v: vals) v.foo = -1;
+    if (rg.emplace_bulk<TestComponent>(ents, std::move(vals)) != 0) return 5;
+    if (rg.get<TestComponent>(ents[5])->foo != -1 || rg.get<TestComponent>(ents[10])->foo != 10) return 6;
+    std::vector<SoaPosition> pos = {{1, 2, 0.5}, {3, 4, 1.5}};
+    if (rg.emplace_bulk<SoaPosition>(ents, pos) != 2) return 7;
+    if (rg.get<SoaPosition>(ents[1])->get<1>() != 4) return 8;
+    return 0;
+}
+
+static_assert(emplace_bulk_test() == 0);
+
+struct RecyclingSparseTraits: SparseSetRegistryTraits {
+    static constexpr bool recycle_entity_ids = true;
+};
+
+template<typename Reg>
+constexpr int recycling_test() {
+    Reg rg;
+    auto a = rg.create_entity();
+    auto b = rg.create_entity();
+    rg.template set<TestComponent>(a, {1});
+    rg.template set<TestComponent>(b, {2});
+    if (a.index() != 1 || b.index() != 2 || a.generation() != 0) return 1;
+    rg.destroy_entity(a);
+    if (rg.is_alive(a) || !rg.is_alive(b)) return 2;
+    auto c = rg.create_entity();
+    //index is reused, stale handle differs by generation
+    if (c.index() != a.index() || c.generation() != 1 || c == a) return 3;
+    if (rg.is_alive(a) || !rg.is_alive(c)) return 4;
+    if (rg.template has<TestComponent>(c) || rg.template get<TestComponent>(a)) return 5;
+    rg.template set<TestComponent>(c, {3});
+    //destroying stale handle doesn't affect the new entity
+    rg.destroy_entity(a);
+    if (!rg.is_alive(c) || rg.template get<TestComponent>(c)->foo != 3) return 6;
+    //neither does setting a component through it
+    if (rg.template set<TestComponent>(a, {999})) return 10;
+    if (rg.template get<TestComponent>(c)->foo != 3 || rg.template has<TestComponent>(a)) return 11;
+    if (rg.template emplace<TestComponent>(a) || rg.template get<TestComponent>(c)->foo != 3) return 12;
+    if (!rg.template emplace<TestComponent>(c) || rg.template get<TestComponent>(c)->foo != 0) return 13;
+    rg.template set<TestComponent>(c, {3});
+    auto range = rg.create_entities(3);
+    if (range[0].index() != 3 || !rg.is_alive(range[2])) return 7;
+    for (int i = 0; i < 100; ++i) {
+        auto e = rg.create_entity();
+        rg.template set<TestComponent>(e, {i});
+        rg.destroy_entity(e);
+    }
+    //churn doesn't grow the ids
+    if (rg.create_entity().index() != 6) return 8;
+    if (rg.template all_of<TestComponent>().size() != 2) return 9;
+    return 0;
+}
+
+static_assert(recycling_test<RegistryRecycling>() == 0);
+static_assert(recycling_test<GenericRegistry<RecyclingSparseTraits> >() == 0);
+
+struct TrackedPosition {
+    static constexpr bool track_changes = true;
+    int x;
+    int y;
+};
+
+template<typename View>
+constexpr int count_rows(View &&v) {
+    int n = 0;
+    for (auto &&row: v) {
+        (void)row;
+        ++n;
+    }
+    return n;
+}
+
+constexpr int change_tracking_test() {
+    Registry rg = prepare_test_registry();
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(3, Entity::is_const_eval{});
+    rg.set<TrackedPosition>(aaa, {1, 1});
+    rg.set<TrackedPosition>(bbb, {2, 2});
+    auto since = rg.advance_tick();
+    if (count_rows(rg.view<TrackedPosition>().changed_since(since)) != 0) return 1;
+    rg.set<TrackedPosition>(ccc, {3, 3});
+    rg.get<TrackedPosition>(aaa)->x = 10;
+    //const access doesn't stamp
+    if (rg.get<const TrackedPosition>(bbb)->x != 2) return 2;
+    //neither does a query
+    if (!rg.has<TrackedPosition>(bbb) || !rg.has<TrackedPosition, TestComponent>(bbb, {})) return 10;
+    if (count_rows(rg.view<TrackedPosition>().changed_since(since)) != 2) return 3;
+    if (count_rows(rg.view<TrackedPosition>().added_since(since)) != 1) return 4;
+    //join with untracked component, ccc has no TestComponent
+    for (auto [e, p, t]: rg.view<const TrackedPosition, TestComponent>().changed_since(since)) {
+        if (e != aaa || p.x != 10) return 5;
+    }
+    since = rg.advance_tick();
+    if (!rg.mark_dirty<TrackedPosition>(bbb) || rg.mark_dirty<TrackedPosition>(Entity(99, Entity::is_const_eval{}))) return 6;
+    //removal moves last item, ticks must follow
+    rg.remove<TrackedPosition>(aaa);
+    auto changed = rg.view<TrackedPosition>().changed_since(since);
+    if (count_rows(changed) != 1 || std::get<0>(*changed.begin()) != bbb) return 7;
+    rg.group<TrackedPosition, TestComponent>();
+    if (count_rows(rg.view<TrackedPosition>().changed_since(since)) != 1) return 8;
+    if (count_rows(rg.view<TrackedPosition>().added_since(1)) != 2) return 9;
+    return 0;
+}
+
+static_assert(change_tracking_test() == 0);
+static_assert(std::ranges::forward_range<decltype(std::declval<Registry &>().view<TrackedPosition>().changed_since(0))>);
+
+struct Frozen {
+    int since;
+};
+
+constexpr int filtered_view_test() {
+    Registry rg = prepare_test_registry();
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(3, Entity::is_const_eval{});
+    auto ddd = Entity(4, Entity::is_const_eval{});
+    rg.set<TestComponent>(ccc, {7});
+    //pool of Frozen doesn't exist yet
+    if (count_rows(rg.view<TestComponent, Exclude<Frozen> >()) != 3) return 1;
+    rg.set<Frozen>(bbb, {1});
+    if (count_rows(rg.view<const TestComponent, Exclude<Frozen> >()) != 2) return 2;
+    for (auto [e, t]: rg.view<TestComponent, Exclude<Frozen> >()) {
+        if (e == bbb) return 3;
+        t.foo += 1;
+    }
+    if (rg.get<TestComponent>(ddd)->foo != 56 || rg.get<TestComponent>(bbb)->foo != 42) return 4;
+    rg.remove<EntityName>(ccc);
+    int with_name = 0;
+    for (auto [e, t, f, n]: rg.view<TestComponent, Optional<const Frozen, EntityName> >()) {
+        if (f.has_value() != (e == bbb)) return 5;
+        if (n) ++with_name;
+    }
+    if (with_name != 2) return 6;
+    for (auto [e, t]: rg.view<const TestComponent, Exclude<EntityName> >()) {
+        if (e != ccc || t.foo != 8) return 7;
+    }
+    return 0;
+}
+
+static_assert(filtered_view_test() == 0);
+static_assert(std::ranges::forward_range<decltype(std::declval<Registry &>().view<TestComponent, Exclude<Frozen> >())>);
+
+constexpr int query_test() {
+    Registry rg = prepare_test_registry();
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(3, Entity::is_const_eval{});
+    Registry::Query<TestComponent, const EntityName> q(rg);
+    if (count_rows(q) != 2 || !q.is_valid()) return 1;
+    //adding components doesn't invalidate
+    rg.set<TestComponent>(ccc, {1});
+    if (!q.is_valid() || count_rows(q) != 3) return 2;
+    for (auto [e, t, n]: q) t.foo += 1;
+    if (rg.get<TestComponent>(ccc)->foo != 2) return 3;
+    //new pool invalidates
+    rg.set<Frozen>(bbb, {1});
+    if (q.is_valid()) return 4;
+    auto q2 = rg.query<const TestComponent, Exclude<Frozen> >();
+    if (count_rows(q2) != 2) return 5;
+    rg.remove_all_of<Frozen>();
+    if (q2.is_valid() || count_rows(q2) != 3) return 6;
+    rg.group_entities<TestComponent>({}, [&](Entity e, const TestComponent &){return e == ccc;});
+    if (q.is_valid() || count_rows(q) != 3) return 7;
+    return 0;
+}
+
+static_assert(query_test() == 0);
+
+constexpr int archetype_registry_test() {
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ccc = Entity(3, Entity::is_const_eval{});
+    ArchetypeRegistry rg;
+    rg.set_entity_name(aaa, "aaa");
+    rg.set_entity_name(bbb, "bbb");
+    rg.set_entity_name(ccc, "ccc");
+    if (rg.archetype_count() != 2) return 1;
+    rg.set<TestComponent>(bbb, {42});
+    rg.set<TestComponent>(ccc, {55});
+    rg.set<Frozen>(ccc, {1});
+    if (rg.archetype_count() != 4) return 2;
+    //replace doesn't move the entity
+    if (rg.set<TestComponent>(ccc, {56}) || rg.archetype_count() != 4) return 3;
+    //aaa moves, ccc stays in its archetype
+    if (rg.get_entity_name(aaa) != "aaa" || rg.get<const TestComponent>(ccc)->foo != 56) return 4;
+    if (!rg.has<TestComponent, EntityName>(bbb) || rg.has<Frozen>(bbb)) return 5;
+    //view visits two archetypes
+    int sum = 0;
+    for (auto [e, t, n]: rg.view<TestComponent, const EntityName>()) {
+        t.foo += 1;
+        sum += t.foo;
+        if (n != rg.get_entity_name(e)) return 6;
+    }
+    if (sum != 43 + 57 || rg.view<TestComponent>().size() != 2) return 7;
+    //cached edge back to archetype {EntityName, TestComponent}
+    rg.remove<Frozen>(ccc);
+    if (rg.archetype_count() != 4 || rg.has<Frozen>(ccc) || rg.get<TestComponent>(ccc)->foo != 57) return 8;
+    if (count_rows(rg.view<Frozen>()) != 0) return 9;
+    rg.destroy_entity(bbb);
+    if (rg.is_known(bbb) || rg.get_entity_name(ccc) != "ccc" || rg.get<TestComponent>(ccc)->foo != 57) return 10;
+    rg.remove<EntityName>(aaa);
+    if (rg.get_entity_name(aaa) != "" || !rg.is_known(aaa)) return 11;
+    return 0;
+}
+
+static_assert(archetype_registry_test() == 0);
+static_assert(std::ranges::forward_range<ArchetypeView<TestComponent, const EntityName> >);
+
+constexpr int pool_batch_test() {
+    Registry rg = prepare_test_registry();
+    auto aaa = Entity(1, Entity::is_const_eval{});
+    auto bbb = Entity(2, Entity::is_const_eval{});
+    auto ddd = Entity(4, Entity::is_const_eval{});
+    auto pool = rg.get_component_pool<EntityName>();
+    IComponentPool &ipool = *pool;
+    Entity batch[] = {ddd, Entity(99, Entity::is_const_eval{}), aaa};
+    std::size_t pos[3] = {};
+    if (ipool.index_of_many(batch, pos) != 2) return 1;
+    if (pos[1] != IComponentPool::npos || pos[0] != ipool.index_of(ddd)) return 2;
+    if (ipool.erase_many(batch) != 2 || ipool.size() != 2) return 3;
+    if (rg.get_entity_name(bbb) != "bbb" || rg.has<EntityName>(ddd)) return 4;
+    rg.destroy_entity(bbb);
+    if (rg.has<TestComponent>(bbb) || rg.get<TestComponent>(ddd)->foo != 55) return 5;
+    return 0;
+}
+
+static_assert(pool_batch_test() == 0);
+
+template<typename Reg>
+constexpr int destroy_entities_test() {
+    Reg rg;
+    std::vector<Entity> ents;
+    for (int i = 1; i <= 10; ++i) {
+        Entity e = Entity::from_id(static_cast<std::uint64_t>(i));
+        ents.push_back(e);
+        rg.template set<TestComponent>(e, {i});
+        rg.template set<TrackedPosition>(e, {i, i});
+        if (i % 2) rg.set_entity_name(e, "odd");
+    }
+    //erase from the middle and from the end, unknown and duplicated entity
+    Entity batch[] = {ents[9], ents[2], ents[3], Entity(99, Entity::is_const_eval{}), ents[8], ents[2]};
+    rg.destroy_entities(batch);
+    if (rg.template view<TestComponent>().size() != 6) return 1;
+    for (auto [e, t, p]: rg.template view<const TestComponent, const TrackedPosition>()) {
+        if (e != ents[static_cast<std::size_t>(t.foo - 1)] || p.x != t.foo) return 2;
+        if ((rg.get_entity_name(e) == "odd") != (t.foo % 2 == 1)) return 3;
+    }
+    auto since = rg.advance_tick();
+    rg.template get<TrackedPosition>(ents[7])->x = 100;
+    Entity batch2[] = {ents[0], ents[1], ents[4]};
+    if (rg.template remove_many<TrackedPosition>(batch2) != 3) return 4;
+    auto changed = rg.template view<TrackedPosition>().changed_since(since);
+    if (count_rows(changed) != 1 || std::get<0>(*changed.begin()) != ents[7]) return 5;
+    if (rg.template has<TrackedPosition>(ents[0]) || !rg.template has<TestComponent>(ents[0])) return 6;
+    return 0;
+}
+
+static_assert(destroy_entities_test<Registry>() == 0);
+static_assert(destroy_entities_test<RegistrySparseSet>() == 0);
@@ -0,0 +1,58 @@
+#include "../ecstl/ecstl.hpp"
+#include "check.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace ecstl;
+
+static_assert(Entity::from_id(5) == Entity(5, Entity::is_const_eval{}));
+
+int test_thread_blocks() {
+    constexpr unsigned int threads = 4;
+    constexpr unsigned int per_thread = 1000;
+    std::vector<std::vector<Entity> > created(threads);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.emplace_back([&created, t]{
+            for (unsigned int i = 0; i < per_thread; ++i) created[t].push_back(Entity::create());
+        });
+    }
+    for (auto &w: workers) w.join();
+    std::vector<Entity> all;
+    for (auto &c: created) {
+        //ids created by one thread are increasing
+        CHECK(std::is_sorted(c.begin(), c.end()));
+        all.insert(all.end(), c.begin(), c.end());
+    }
+    std::sort(all.begin(), all.end());
+    CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+    return 0;
+}
+
+int test_wrap_and_bump() {
+    auto e = Entity::create();
+    //wrapping doesn't reserve the id
+    auto far = Entity::from_id(e.id() + 1000000);
+    CHECK(Entity::create_range(1)[0] < far);
+    //the constructor reserves it
+    Entity bumped(far.id());
+    CHECK(Entity::create_range(1)[0] > bumped);
+    return 0;
+}
+
+int test_bump_inside_block() {
+    auto x = Entity::create();
+    //the id lies in the block already held by this thread
+    Entity y(x.id() + 5);
+    for (int i = 0; i < 10; ++i) {
+        auto z = Entity::create();
+        CHECK(z != y);
+        CHECK(z > x);
+    }
+    return 0;
+}
+
+int main() {
+    return test_thread_blocks() + test_wrap_and_bump() + test_bump_inside_block();
+}
@@ -0,0 +1,79 @@
+///Benchmark of erase-heavy workloads of OpenHashMap (not a test, prints times)
+#include "../ecstl/utils/open_hash_map.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ecstl;
+
+template<OpenHashProbing probing>
+using Map = OpenHashMap<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>, probing>;
+
+template<typename Fn>
+static long long measure(Fn &&fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count());
+}
+
+///keeps 100k live keys, each round erases one, inserts new one and looks up other one
+template<OpenHashProbing probing>
+static long long churn() {
+    constexpr std::size_t live = 100000;
+    constexpr std::size_t rounds = 2000000;
+    std::mt19937_64 rnd(1);
+    std::vector<std::uint64_t> keys(live);
+    Map<probing> map;
+    for (auto &k: keys) {
+        k = rnd();
+        map.emplace(k, k);
+    }
+    std::uint64_t found = 0;
+    auto t = measure([&]{
+        for (std::size_t i = 0; i < rounds; ++i) {
+            auto &k = keys[i % live];
+            map.erase(k);
+            k = rnd();
+            map.emplace(k, k);
+            found += map.find(keys[(i * 7) % live]) != map.end();
+        }
+    });
+    if (found != rounds) std::cerr << "unexpected result" << std::endl;
+    return t;
+}
+
+///inserts 200k keys and erases all of them in random order
+template<OpenHashProbing probing>
+static long long erase_all() {
+    constexpr std::size_t count = 200000;
+    constexpr int repeat = 20;
+    std::mt19937_64 rnd(2);
+    std::vector<std::uint64_t> keys(count);
+    for (auto &k: keys) k = rnd();
+    long long t = 0;
+    for (int r = 0; r < repeat; ++r) {
+        Map<probing> map;
+        for (auto k: keys) map.emplace(k, k);
+        std::shuffle(keys.begin(), keys.end(), rnd);
+        t += measure([&]{
+            for (auto k: keys) map.erase(k);
+        });
+        if (map.size() != 0) std::cerr << "unexpected result" << std::endl;
+    }
+    return t;
+}
+
+template<OpenHashProbing probing>
+static void run(const char *name) {
+    std::cout << name << ": churn " << churn<probing>() << " ms, erase all " << erase_all<probing>() << " ms" << std::endl;
+}
+
+int main() {
+    run<OpenHashProbing::linear>("linear");
+    run<OpenHashProbing::swiss>("swiss");
+    run<OpenHashProbing::robin_hood>("robin_hood");
+}
@@ -0,0 +1,89 @@
+#include "../ecstl/ecstl.hpp"
+#include "../ecstl/signals_async.hpp"
+#include "check.h"
+#include <vector>
+
+using namespace ecstl;
+
+struct Position {
+    int x = 0;
+};
+
+struct Velocity {
+    int v = 0;
+};
+
+
+static Registry prepare(std::vector<Entity> &ents, unsigned int count) {
+    Registry db;
+    for (unsigned int i = 0; i < count; ++i) {
+        auto e = db.create_entity();
+        ents.push_back(e);
+        db.set<Position>(e, {static_cast<int>(i)});
+        //only every third entity has velocity
+        if (i % 3 == 0) db.set<Velocity>(e, {2});
+    }
+    return db;
+}
+
+int test_parallel() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 10000);
+    auto disp = AsyncSignalDispatcher<4>::create();
+
+    std::atomic<unsigned int> visited = 0;
+    db.view<Position, Velocity>().parallel_for_each(disp, [&](Entity, Position &p, Velocity &v) {
+        p.x += v.v;
+        ++visited;
+    }, 100);
+    CHECK_EQUAL(visited.load(), 3334U);
+    for (unsigned int i = 0; i < ents.size(); ++i) {
+        int expected = static_cast<int>(i) + (i % 3 == 0?2:0);
+        auto p = db.get<const Position>(ents[i]);
+        if (!p || p->x != expected) {
+            CHECK_EQUAL(p?p->x:-1, expected);
+        }
+    }
+    return 0;
+}
+
+int test_parallel_no_threads() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 1000);
+    //dispatcher without threads - calling thread processes everything
+    auto disp = AsyncSignalDispatcher<0>::create();
+
+    std::atomic<unsigned int> visited = 0;
+    db.view<Position>().parallel_for_each(disp, [&](auto row) {
+        std::get<1>(row).x = -1;
+        ++visited;
+    }, 64);
+    CHECK_EQUAL(visited.load(), 1000U);
+    disp.pump_all();
+    for (auto [e, p]: db.view<Position>()) {
+        if (p.x != -1) CHECK_EQUAL(p.x, -1);
+    }
+    return 0;
+}
+
+int test_parallel_grouped() {
+    std::vector<Entity> ents;
+    auto db = prepare(ents, 5000);
+    db.group<Position, Velocity>();
+    auto disp = AsyncSignalDispatcher<3>::create();
+
+    std::atomic<unsigned int> visited = 0;
+    db.view<Velocity, Position>().parallel_for_each(disp, [&](Entity, Velocity &v, Position &p) {
+        v.v = p.x;
+        ++visited;
+    }, 50);
+    CHECK_EQUAL(visited.load(), 1667U);
+    for (auto [e, v, p]: db.view<Velocity, Position>()) {
+        if (v.v != p.x) CHECK_EQUAL(v.v, p.x);
+    }
+    return 0;
+}
+
+int main() {
+    return test_parallel() + test_parallel_no_threads() + test_parallel_grouped();
+}
@@ -0,0 +1,52 @@
+#include "../ecstl/ecstl.hpp"
+#include "../ecstl/registry_shrptr.hpp"
+#include "check.h"
+
+using namespace ecstl;
+
+struct Health {
+    int hp;
+};
+
+struct Armor {
+    int value;
+};
+
+static_assert(Registry::indexes_pools);
+static_assert(!RegistrySharedPtr::indexes_pools);
+
+int test_indexed_lookup() {
+    CHECK(component_type_index<Health>() != component_type_index<Armor>());
+    CHECK(component_type_index<Health>() == component_type_index<Health>());
+    Registry r;
+    auto e = r.create_entity("e");
+    CHECK(!r.get<Health>(e));
+    r.set<Health>(e, {10});
+    r.set<Health>(e, ComponentTypeID(1), {20});
+    CHECK(r.get<Health>(e)->hp == 10);
+    CHECK(r.get<const Health>(e, ComponentTypeID(1))->hp == 20);
+    //pool is removed and created again
+    r.remove_all_of<Health>();
+    CHECK(!r.get<Health>(e));
+    CHECK(r.get<Health>(e, ComponentTypeID(1))->hp == 20);
+    r.set<Health>(e, {11});
+    CHECK(r.get<const Health>(e)->hp == 11);
+    //pool is replaced
+    r.set<Armor>(e, {1});
+    auto f = r.create_entity("f");
+    r.set<Armor>(f, {2});
+    CHECK(r.group_entities<Armor>({}, [&](Entity x, const Armor &){return x == f;}));
+    CHECK(r.get<Armor>(f)->value == 2);
+    r.remove<Armor>(e);
+    CHECK(!r.has<Armor>(e));
+    CHECK(r.view<Armor>().size() == 1);
+    //index moves with the pools
+    Registry r2 = std::move(r);
+    CHECK(r2.get<Armor>(f)->value == 2);
+    CHECK(!r.get<Armor>(f));
+    return 0;
+}
+
+int main() {
+    return test_indexed_lookup();
+}
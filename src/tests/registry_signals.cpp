@@ -0,0 +1,103 @@
+#include "../ecstl/ecstl.hpp"
+#include "check.h"
+#include <map>
+#include <vector>
+
+using namespace ecstl;
+
+struct Position {
+    int x = 0;
+    int y = 0;
+};
+
+struct Health {
+    int hp = 0;
+};
+
+///Keeps position of entities in an external index
+struct SpatialIndex {
+    std::map<Entity, int> xs;
+    int updates = 0;
+};
+
+int test_lifecycle() {
+    RegistrySignaling db;
+    SpatialIndex idx;
+    auto c1 = connect(db.on_construct<Position>(), [&](Entity e) noexcept {
+        idx.xs[e] = db.get<const Position>(e)->x;
+    });
+    auto c2 = connect(db.on_update<Position>(), [&](Entity e) noexcept {
+        idx.xs[e] = db.get<const Position>(e)->x;
+        ++idx.updates;
+    });
+    auto c3 = connect(db.on_destroy<Position>(), [&](Entity e) noexcept {
+        //component is still readable
+        if (db.has<Position>(e)) idx.xs.erase(e);
+    });
+    std::vector<Entity> ents;
+    for (int i = 0; i < 10; ++i) {
+        auto e = db.create_entity();
+        db.set<Position>(e, {i, 0});
+        db.set<Health>(e, {100});
+        ents.push_back(e);
+    }
+    CHECK_EQUAL(idx.xs.size(), 10U);
+    db.set<Position>(ents[3], {30, 0});
+    db.emplace<Position>(ents[4], 40, 0);
+    CHECK_EQUAL(idx.updates, 2);
+    CHECK_EQUAL(idx.xs[ents[3]], 30);
+    db.emplace<Position>(db.create_entity());
+    CHECK_EQUAL(idx.xs.size(), 11U);
+
+    db.remove<Position>(ents[0]);
+    db.remove<Position>(ents[0]);   //not present, no signal
+    db.destroy_entity(ents[1]);
+    CHECK_EQUAL(idx.xs.size(), 9U);
+    CHECK(!idx.xs.contains(ents[0]));
+    CHECK(!idx.xs.contains(ents[1]));
+
+    //removal of other component doesn't emit
+    db.remove<Health>(ents[2]);
+    CHECK_EQUAL(idx.xs.size(), 9U);
+
+    db.remove_all_of<Position>();
+    CHECK(idx.xs.empty());
+    return 0;
+}
+
+int test_command_buffer_and_disconnect() {
+    RegistrySignaling db;
+    int constructed = 0;
+    auto c = connect(db.on_construct<Health>(), [&](Entity) noexcept {++constructed;});
+    RegistrySignaling::CommandBuffer cmd;
+    auto e = cmd.create_entity();
+    cmd.set<Health>(e, {1});
+    cmd.set<Health>(cmd.create_entity(), {2});
+    db.apply(std::move(cmd));
+    CHECK_EQUAL(constructed, 2);
+    c.reset();
+    db.set<Health>(db.create_entity(), {3});
+    CHECK_EQUAL(constructed, 2);
+    return 0;
+}
+
+int test_observer_removes_pool() {
+    RegistrySignaling db;
+    auto c = connect(db.on_construct<Health>(), [&](Entity) noexcept {db.remove_all_of<Health>();});
+    auto e = db.create_entity();
+    //component is gone when emplace returns
+    CHECK(!db.emplace<Health>(e));
+    std::vector<Entity> ents;
+    for (int i = 0; i < 5; ++i) ents.push_back(db.create_entity());
+    CHECK_EQUAL(db.emplace_bulk<Health>(ents, std::vector<Health>(5, Health{1})), 5U);
+    CHECK(db.all_of<Health>().empty());
+    RegistrySignaling::CommandBuffer cmd;
+    for (auto x: ents) cmd.set<Health>(x, {2});
+    db.apply(std::move(cmd));
+    CHECK(db.all_of<Health>().empty());
+    return 0;
+}
+
+int main() {
+    return test_lifecycle() + test_command_buffer_and_disconnect() + test_observer_removes_pool();
+}
@@ -0,0 +1,154 @@
+#include "../ecstl/ecstl.hpp"
+#include "../ecstl/registry_shrptr.hpp"
+#include "check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ecstl;
+
+struct Position {
+    int x = 0;
+};
+
+struct Health {
+    int hp = 0;
+};
+
+int test_copy_on_write() {
+    RegistryCopyOnWrite db;
+    std::vector<Entity> ents;
+    for (int i = 0; i < 100; ++i) {
+        auto e = db.create_entity(std::to_string(i));
+        db.set<Position>(e, {i});
+        db.set<Health>(e, {100});
+        ents.push_back(e);
+    }
+    auto snap = db.snapshot();
+    //nothing is copied until modified
+    CHECK(snap->get_component_pool<const Position>() == db.get_component_pool<const Position>());
+
+    for (auto [e, p]: db.view<Position>()) p.x += 1000;
+    db.set<Position>(db.create_entity(), {-1});
+    db.remove<Position>(ents[0]);
+    db.set_entity_name(ents[1], "renamed");
+
+    CHECK(snap->get_component_pool<const Position>() != db.get_component_pool<const Position>());
+    //health was not modified, pool is still shared
+    CHECK(snap->get_component_pool<const Health>() == db.get_component_pool<const Health>());
+    CHECK_EQUAL(snap->all_of<const Position>().size(), 100U);
+    CHECK_EQUAL(db.all_of<const Position>().size(), 100U);
+    CHECK_EQUAL(snap->get<const Position>(ents[5])->x, 5);
+    CHECK_EQUAL(db.get<const Position>(ents[5])->x, 1005);
+    CHECK(snap->has<Position>(ents[0]));
+    CHECK(!db.has<Position>(ents[0]));
+    CHECK_EQUAL(snap->get_entity_name(ents[1]), std::string_view("1"));
+    CHECK_EQUAL(db.get_entity_name(ents[1]), std::string_view("renamed"));
+
+    //pool is copied only once per snapshot
+    auto pool = db.get_component_pool<const Position>();
+    db.set<Position>(ents[2], {7});
+    CHECK(pool == db.get_component_pool<const Position>());
+
+    //non-const access to the snapshot makes private copy
+    auto snap_health = snap->get_component_pool<const Health>();
+    snap->get<Health>(ents[3])->hp = 1;
+    CHECK(snap_health != snap->get_component_pool<const Health>());
+    CHECK_EQUAL(db.get<const Health>(ents[3])->hp, 100);
+    return 0;
+}
+
+int test_snapshot_released() {
+    RegistryCopyOnWrite db;
+    auto e = db.create_entity();
+    db.set<Position>(e, {1});
+    auto pool = db.get_component_pool<const Position>();
+    db.snapshot().reset();
+    pool.reset();
+    //no other owner, pool is modified in place
+    auto before = db.get_component_pool<const Position>().get();
+    db.set<Position>(e, {2});
+    CHECK(before == db.get_component_pool<const Position>().get());
+    CHECK((!db.create_owning_group<Position, Health>()));
+    return 0;
+}
+
+int test_reader_thread() {
+    RegistryCopyOnWrite db;
+    for (int i = 0; i < 1000; ++i) db.set<Position>(db.create_entity(), {0});
+    std::atomic<bool> ok = true;
+    for (int frame = 1; frame <= 20; ++frame) {
+        auto snap = db.snapshot();
+        std::thread render([snap, &ok, frame]{
+            //every frame sees consistent state
+            for (auto [e, p]: snap->view<const Position>()) {
+                if (p.x != frame - 1) ok = false;
+            }
+        });
+        for (auto [e, p]: db.view<Position>()) p.x = frame;
+        render.join();
+    }
+    CHECK(ok.load());
+    return 0;
+}
+
+int test_cached_query() {
+    RegistryCopyOnWrite db;
+    for (int i = 0; i < 10; ++i) db.set<Position>(db.create_entity(), {i});
+    RegistryCopyOnWrite::Query<Position> q(db);
+    for (auto [e, p]: q) p.x += 1;
+    auto snap = db.snapshot();
+    //snapshot invalidates the query, so the pool is copied before the write
+    CHECK(!q.is_valid());
+    for (auto [e, p]: q) p.x += 100;
+    int sum_db = 0, sum_snap = 0;
+    for (auto [e, p]: db.view<const Position>()) sum_db += p.x;
+    for (auto [e, p]: snap->view<const Position>()) sum_snap += p.x;
+    CHECK_EQUAL(sum_snap, 55);
+    CHECK_EQUAL(sum_db, 1055);
+    return 0;
+}
+
+int test_read_only_queries() {
+    RegistryCopyOnWrite db;
+    auto e = db.create_entity("reader");
+    db.set<Position>(e, {1});
+    auto snap = db.snapshot();
+    auto epoch = db.pool_epoch();
+    //queries don't copy shared pools
+    CHECK(db.has<Position>(e));
+    CHECK((db.has<Position, EntityName>(e, {})));
+    CHECK_EQUAL(db.get_entity_name(e), std::string_view("reader"));
+    CHECK(db.find_by_name("reader") == e);
+    CHECK(snap->get_component_pool<const Position>() == db.get_component_pool<const Position>());
+    CHECK(snap->get_component_pool<const EntityName>() == db.get_component_pool<const EntityName>());
+    CHECK_EQUAL(db.pool_epoch(), epoch);
+    return 0;
+}
+
+int test_for_each_component() {
+    RegistryCopyOnWrite db;
+    auto e = db.create_entity();
+    db.set<Position>(e, {1});
+    db.set<Health>(e, {2});
+    auto snap = db.snapshot();
+    //read only visitor doesn't copy
+    int sum = 0;
+    db.for_each_component(e, [&](ConstAnyRef c) {
+        if (auto p = c.get_if<Position>()) sum += p->x;
+    });
+    CHECK_EQUAL(sum, 1);
+    CHECK(snap->get_component_pool<const Position>() == db.get_component_pool<const Position>());
+    //writing visitor detaches visited pools
+    db.for_each_component(e, [&](AnyRef c) {
+        if (auto p = c.get_if<Position>()) p->x = 42;
+    });
+    CHECK_EQUAL(db.get<const Position>(e)->x, 42);
+    CHECK_EQUAL(snap->get<const Position>(e)->x, 1);
+    return 0;
+}
+
+int main() {
+    return test_copy_on_write() + test_snapshot_released() + test_reader_thread() + test_cached_query()
+        + test_read_only_queries() + test_for_each_component();
+}